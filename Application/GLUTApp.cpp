@@ -8,9 +8,9 @@
 
 // C++ standard library & STL
 #include <string>
-#include <stack>
-#include <queue>
-#include <set>
+#include <vector>
+#include <new>
+#include <fstream>
 using namespace std;
 
 // Windows/OpenGL
@@ -22,9 +22,21 @@ using namespace std;
 #include "..\Utilities\Singleton.h"
 #include "..\Utilities\Timer.h"
 #include "..\Utilities\SettingFile.h"
+#include "..\Utilities\FileWatcher.h"
+#include "..\Utilities\Profiler.h"
+#include "..\Utilities\Telemetry.h"
+#include "..\Utilities\MemoryStats.h"
+#include "..\Utilities\JobSystem.h"
+#include "..\Utilities\FrameArena.h"
+#include "..\Utilities\AllocationTracker.h"
+#include "..\Utilities\Exceptions.h"
 
 #include "..\IGameState.h"
+#include "..\GameStatePool.h"
+#include "..\EngineContext.h"
 #include "..\Camera.h"
+#include "PerformanceHUD.h"
+#include "MemoryReport.h"
 
 
 // ------------------------------------------------------------------------------------
@@ -59,20 +71,88 @@ RenderTextData::RenderTextData( const std::string &Text, const Vector2f &Positio
 int GLUTApp::Run( const string &SettingsPath, HINSTANCE hInstance, char *CommandLine, int ShowCommand )
 {
     // Allocate memory
-    StateStack = new stack<IGameState *>;
+    StateStack = new vector<StateStackEntry>;
+    StateStack->reserve( 8 );
     UpdateTimer = new PerformanceTimer;
-    TextToRender = new queue<RenderTextData *>;
-	PressedSet = new set<unsigned char>;
-    MotionQueue = new queue<Vector2f>;
-    ButtonQueue = new queue<int>;
-
-    // Load settings
-    SettingFile Settings( SettingsPath.c_str() );
-    const string &WindowTitle = Settings.GetValue( "WindowTitle" ),
-                 &InitialStateID = Settings.GetValue( "InitialStateID" );
-    WindowWidth = Settings.GetValueAs<int>( "WindowWidth" );
-    WindowHeight = Settings.GetValueAs<int>( "WindowHeight" );
-    bool Fullscreen = Settings.GetValueAs<int>( "Fullscreen" ) == 1;
+    HUD = new PerformanceHUD;
+    Telemetry = new TelemetryPublisher;
+    InputEvents = new InputEventQueue;
+    ProfileReportPath = new string;
+    MemoryReportPath = new string( "MemoryReport.txt" );
+
+    // Load settings, optionally watching them for changes
+    Settings = new SettingFile( SettingsPath.c_str() );
+    SettingsWatcher = new FileWatcher;
+    if (Settings->GetValueAs<bool>( "SettingsHotReload", false ))
+        SettingsWatcher->Watch( SettingsPath.c_str() );
+    SettingsError = new RenderTextData( "", Vector2f(0, 0), Color3f(1, 0, 0) );
+    const string &WindowTitle = Settings->GetValue( "WindowTitle" ),
+                 &InitialStateID = Settings->GetValue( "InitialStateID" );
+    WindowWidth = Settings->GetValueAs<int>( "WindowWidth" );
+    WindowHeight = Settings->GetValueAs<int>( "WindowHeight" );
+    bool Fullscreen = Settings->GetValueAs<int>( "Fullscreen" ) == 1;
+
+    // Game context, optionally with a fixed random seed for reproducible runs
+    if (Settings->HasSetting( "RandomSeed" ))
+        Context = new EngineContext( *this, Settings->GetValueAs<unsigned long>( "RandomSeed" ) );
+    else
+        Context = new EngineContext( *this );
+    Context->Settings = Settings;
+
+    // Per-frame scratch memory
+    size_t FrameArenaBytes = 64 * 1024;
+    if (Settings->HasSetting( "FrameArenaBytes" ))
+        FrameArenaBytes = Settings->GetValueAs<size_t>( "FrameArenaBytes" );
+    FrameMemory = new FrameArena( FrameArenaBytes );
+    Context->FrameMemory = FrameMemory;
+    BeginFrameMemory();
+
+    // Construct every game state up front so transitions only Init() and DeInit()
+    States = new GameStatePool( *Context );
+    States->Prewarm();
+
+    // Start the shared worker pool, by default one worker per additional hardware thread
+    int JobWorkers = Settings->HasSetting( "JobWorkers" ) ? Settings->GetValueAs<int>( "JobWorkers" ) : 0;
+    bool JobPinWorkers = Settings->HasSetting( "JobPinWorkers" ) && Settings->GetValueAs<int>( "JobPinWorkers" ) == 1;
+    Singleton<JobSystem, AtomicDoubleCheckedCreation>::Instance().Start( JobWorkers, JobPinWorkers );
+
+    // Optional profiling output. Hardware counters are sampled only for the listed zones.
+    if (Settings->HasSetting( "ProfileReportPath" ))
+        *ProfileReportPath = Settings->GetValue( "ProfileReportPath" );
+    if (Settings->HasSetting( "ProfileCounters" ))
+        Singleton<Profiler>::Instance().EnableCounters( Settings->GetValue( "ProfileCounters" ) );
+    MemoryReportOnExit = Settings->HasSetting( "MemoryReportPath" );
+    if (MemoryReportOnExit)
+        *MemoryReportPath = Settings->GetValue( "MemoryReportPath" );
+    if (Settings->HasSetting( "ShowPerformanceHUD" ))
+        HUD->SetVisible( Settings->GetValueAs<int>( "ShowPerformanceHUD" ) == 1 );
+
+    // Optional steady-state allocation check: 1 reports heap allocations made during a tick,
+    // 2 asserts on them. Needs a TRACK_ALLOCATIONS build.
+    TickCount = 0;
+    LastTickAllocations = 0;
+    AllocationCheckAfterTicks = 0;
+    if (Settings->HasSetting( "AllocationCheck" ) && Settings->GetValueAs<int>( "AllocationCheck" ) != 0)
+    {
+        AllocationTracker::SetCheckMode( Settings->GetValueAs<int>( "AllocationCheck" ) == 2 ? ALLOCATION_CHECK_ASSERT : ALLOCATION_CHECK_REPORT );
+
+        // Give caches and containers time to reach their working size first
+        AllocationCheckAfterTicks = 300;
+        if (Settings->HasSetting( "AllocationCheckAfterTicks" ))
+            AllocationCheckAfterTicks = Settings->GetValueAs<unsigned long long>( "AllocationCheckAfterTicks" );
+    }
+
+    // Optional shared memory telemetry, see Tools\TelemetryTail.cpp for a reader
+    if (Settings->HasSetting( "TelemetryName" ))
+    {
+        unsigned int Capacity = 4096;
+        if (Settings->HasSetting( "TelemetryCapacity" ))
+            Capacity = Settings->GetValueAs<unsigned int>( "TelemetryCapacity" );
+
+        Telemetry->Open( Settings->GetValue( "TelemetryName" ), Capacity );
+        TelemetryStartTicks = Profiler::GetTicks();
+        TelemetryMemoryBytes = GetResidentBytes();
+    }
 
     // Initialize OpenGL & window
     glutInit( &ShowCommand, &CommandLine );
@@ -107,11 +187,8 @@ int GLUTApp::Run( const string &SettingsPath, HINSTANCE hInstance, char *Command
     // Set buffer clear color to white
     glClearColor( 1, 1, 1, 1 );
 
-    // Initialize first state
-	PushState( InitialStateID );
-
-    // Set perspective matrix
-    ApplyGLPerspectiveMatrix();
+    // Initialize first state, this also sets the perspective matrix
+	PushState( HashedID( InitialStateID.c_str() ) );
 
     // Run
     glutMainLoop();
@@ -128,39 +205,118 @@ void GLUTApp::Exit()
 
 void GLUTApp::Destroy()
 {
-    for (; !StateStack->empty(); StateStack->pop())
-        delete StateStack->top();
+    // Join worker threads before any state they might reference is freed
+    Singleton<JobSystem, AtomicDoubleCheckedCreation>::Instance().Stop();
+
+    if (MemoryReportOnExit)
+        AppendMemoryReport();
+
+    // Write profile report
+    if (!ProfileReportPath->empty())
+    {
+        ofstream fout( ProfileReportPath->c_str(), ios::out | ios::trunc );
+        if (fout.good())
+        {
+            Singleton<Profiler>::Instance().WriteReport( fout );
+
+            fout << '\n';
+            FrameMemory->WriteReport( fout );
+
+            fout << '\n';
+            AllocationTracker::WriteReport( fout );
+        }
+    }
+
+    for (; !StateStack->empty(); StateStack->pop_back())
+        States->Release( StateStack->back().ID, StateStack->back().State );
 
     delete StateStack;
+    delete States;
+    delete Context;
     delete UpdateTimer;
-    delete TextToRender;
-    delete PressedSet;
-    delete MotionQueue;
-    delete ButtonQueue;
+    delete HUD;
+    delete Telemetry;
+    delete FrameMemory;
+    delete InputEvents;
+    delete ProfileReportPath;
+    delete MemoryReportPath;
+    delete Settings;
+    delete SettingsWatcher;
+    delete SettingsError;
 }
 
-void GLUTApp::PushState( const string &StateID )
+void GLUTApp::PushState( const HashedID &StateID )
 {
-    // Create instance of new state
-	IGameState *NewState = IGameState::New( StateID );
+    PROFILE_SCOPE( "PushState" );
+    ALLOCATION_TAG( "GameStates" );
 
-    // Initialize it
-	NewState->Init();
+    // Get an initialized instance of the new state
+	IGameState *NewState = States->Acquire( StateID );
+    if (NewState == NULL)
+        throw LogicException( string() + "Game state \"" + StateID.GetName() + "\" is not registered." );
 
     // Push it onto stack
-	StateStack->push( NewState );
+    StateStackEntry Entry = { NewState, StateID };
+	StateStack->push_back( Entry );
+
+    // The new state may have brought its own camera
+    ApplyGLPerspectiveMatrix();
 }
 
 void GLUTApp::PopState()
 {
-    // Get reference to top state
-    IGameState *TopState = StateStack->top();
+    PROFILE_SCOPE( "PopState" );
+
+    // Pop the top state and return it to the pool
+    StateStackEntry Top = StateStack->back();
+    StateStack->pop_back();
+    States->Release( Top.ID, Top.State );
+}
+
+void GLUTApp::ReleaseFinishedStates()
+{
+    PROFILE_SCOPE( "PopState" );
 
-    // Pop it from the stack
-    StateStack->pop();
+    // A state finishes in its own Update(), often right after pushing its successor, so
+    // finished states are not necessarily on top
+    unsigned int Kept = 0;
+    for (unsigned int i = 0; i < StateStack->size(); i++)
+    {
+        StateStackEntry &Entry = (*StateStack)[i];
+        if (Entry.State->IsFinished())
+            States->Release( Entry.ID, Entry.State );
+        else
+            (*StateStack)[Kept++] = Entry;
+    }
 
-    // Free it
-    delete TopState;
+    StateStack->erase( StateStack->begin() + Kept, StateStack->end() );
+}
+
+void GLUTApp::ReloadSettings()
+{
+    PROFILE_SCOPE( "ReloadSettings" );
+    ALLOCATION_TAG( "Settings" );
+
+    // A file that fails to load leaves the settings unchanged. One caught half written fails
+    // to parse, and the write that completes it triggers another reload. A value a state
+    // can't parse is reported the same way, states before it have already applied theirs.
+    // The file is read rather than mapped, so one truncated mid-read can't fault the game.
+    try
+    {
+        Settings->Reload( SettingsWatcher->GetPath().c_str() );
+
+        // Window and engine settings only take effect at startup
+        for (unsigned int i = 0; i < StateStack->size(); i++)
+            (*StateStack)[i].State->ApplySettings( *Settings );
+    }
+    catch (CausedException &Error)
+    {
+        SettingsError->Text = "Settings not reloaded: " + (Error.GetCause().empty() ? Error.GetDescription() : Error.GetCause());
+        SettingsError->Position = Vector2f( 10, WindowHeight - 20.0f );
+        return;
+    }
+
+    SettingsError->Text.clear();
 }
 
 void GLUTApp::OnUpdate()
@@ -169,50 +325,162 @@ void GLUTApp::OnUpdate()
     float Elapsed = UpdateTimer->GetElapsed();
     UpdateTimer->Reset();
 
+    // The previous frame is over, roll per-frame statistics
+    PROFILE_SET_COUNT( "FrameArenaBytes", FrameMemory->GetUsedBytes() );
+    if (AllocationTracker::IsEnabled())
+    {
+        unsigned long long Allocations = AllocationTracker::GetThreadStats().Allocations;
+        PROFILE_SET_COUNT( "Allocations", Allocations - LastTickAllocations );
+        LastTickAllocations = Allocations;
+    }
+    Singleton<Profiler>::Instance().EndFrame();
+    BeginFrameMemory();
+    HUD->AddFrameTime( Elapsed );
+    PublishTelemetry( Elapsed );
+
+    // Settings changes are applied between ticks, never in the middle of one
+    if (SettingsWatcher->HasChanged())
+        ReloadSettings();
+
+    // Gather input that arrived since the last update
+    DrainInputEvents();
+
+    // Toggle performance overlay on H key press
+    if (Context->Input.IsKeyPressed( 'h' ))
+        HUD->Toggle();
+
+    // Snapshot memory use on M key press
+    if (Context->Input.IsKeyPressed( 'm' ))
+        AppendMemoryReport();
+
+    // Flag heap allocations for the rest of the tick once past the warm-up
+    TickCount++;
+    AllocationCheckScope SteadyState( AllocationCheckAfterTicks > 0 && TickCount >= AllocationCheckAfterTicks );
+
     // Get reference to current state
-	IGameState *CurrentState = StateStack->top();
+	IGameState *CurrentState = StateStack->back().State;
 
     // Update current state
-    CurrentState->Update( Elapsed );
+    {
+        PROFILE_SCOPE( "Update" );
+        CurrentState->Update( Elapsed );
+    }
+
+    ReleaseFinishedStates();
 
-	// Only Update() should change the current game state, so check for a new top state
-	if (CurrentState != StateStack->top())
+    // If no more states exist then the game must be over
+    if (StateStack->empty())
+        Exit();
+
+	// Only Update() should change the current game state, so check for a new top state.
+	// This tick's input has been handled, don't let it carry over to the next one.
+	if (CurrentState != StateStack->back().State)
+	{
+		Context->Input.Clear();
 		return;
+	}
 
-    // Check if the current state is finished
-    if (CurrentState->IsFinished())
     {
-		PopState();
+        PROFILE_SCOPE( "Render" );
 
-		// If no more states exist then the game must be over
-		if (StateStack->empty())
-			Singleton<GLUTApp>::Instance().Exit();
+        // Clear screen & depth buffer
+        glClear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT );
 
-		return;
-    }
+        // Invoke render for current game state
+        CurrentState->Render();
 
-    // Clear screen & depth buffer
-    glClear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT );
+        // Queue performance overlay text
+        HUD->Render( *this );
+        if (!SettingsError->Text.empty())
+            RenderText( SettingsError );
 
-    // Invoke render for current game state
-    CurrentState->Render();
+        // Render text
+        RenderTextQueue();
+    }
 
-    // Render text
-    RenderTextQueue();
+    // Driver allocations are out of our hands
+    {
+        ALLOCATIONS_ALLOWED();
 
-    // Swap back buffer to front
-    glutSwapBuffers();
+        // Swap back buffer to front
+        glutSwapBuffers();
 
-    // For reasons unknown to me, calling glutBitmapCharacter() causes GLUT to
-    // fire passive mouse motion events much more frequently, greatly reducing
-    // an otherwise apparent (and unwanted) skipping effect. Since the call is
-    // made after the back buffer swap, the rendered character is never seen.
-    glutBitmapCharacter( GLUT_BITMAP_8_BY_13, ' ' );
+        // For reasons unknown to me, calling glutBitmapCharacter() causes GLUT to
+        // fire passive mouse motion events much more frequently, greatly reducing
+        // an otherwise apparent (and unwanted) skipping effect. Since the call is
+        // made after the back buffer swap, the rendered character is never seen.
+        glutBitmapCharacter( GLUT_BITMAP_8_BY_13, ' ' );
+    }
 
     // Clear user input buffers
-    PressedSet->clear();
-    for (; !MotionQueue->empty(); MotionQueue->pop());
-    for (; !ButtonQueue->empty(); ButtonQueue->pop());
+    Context->Input.Clear();
+}
+
+void GLUTApp::PublishTelemetry( float FrameSeconds )
+{
+    if (!Telemetry->IsOpen())
+        return;
+
+    Profiler &Prof = Singleton<Profiler>::Instance();
+
+    // Look zones and counters up once, registering them if they have not run yet
+    static const int UpdateZone = Prof.RegisterZone( "Update" ),
+                     RenderZone = Prof.RegisterZone( "Render" ),
+                     CollisionZone = Prof.RegisterZone( "Snake::IsSelfColliding" ),
+                     SegmentCounter = Prof.RegisterCounter( "SnakeSegments" ),
+                     CollisionCounter = Prof.RegisterCounter( "CollisionTests" );
+
+    // Resident memory costs a system call, so it is only sampled every 64 ticks
+    static unsigned int Tick = 0;
+    if ((++Tick & 63) == 0)
+        TelemetryMemoryBytes = GetResidentBytes();
+
+    TelemetryRecord Record;
+    Record.TimeSeconds = (Profiler::GetTicks() - TelemetryStartTicks) * Profiler::GetSecondsPerTick();
+    Record.TickMilliseconds = FrameSeconds * 1000;
+    Record.UpdateMilliseconds = static_cast<float>(Prof.GetLastFrameSeconds( UpdateZone ) * 1000);
+    Record.RenderMilliseconds = static_cast<float>(Prof.GetLastFrameSeconds( RenderZone ) * 1000);
+    Record.CollisionMilliseconds = static_cast<float>(Prof.GetLastFrameSeconds( CollisionZone ) * 1000);
+    Record.Segments = static_cast<unsigned int>(Prof.GetLastFrameCount( SegmentCounter ));
+    Record.CollisionTests = static_cast<unsigned int>(Prof.GetLastFrameCount( CollisionCounter ));
+    Record.MemoryBytes = TelemetryMemoryBytes;
+
+    Telemetry->Publish( Record );
+}
+
+void GLUTApp::BeginFrameMemory()
+{
+    FrameMemory->BeginFrame();
+
+    // The old list lived in the reused buffer and is simply abandoned, it never owned heap memory
+    void *ListMemory = FrameMemory->Allocate( sizeof(TextList), alignof(TextList) );
+    TextToRender = new (ListMemory) TextList( FrameAllocator<RenderTextData *>( *FrameMemory ) );
+    TextToRender->reserve( 32 );
+}
+
+void GLUTApp::AppendMemoryReport()
+{
+    ofstream fout( MemoryReportPath->c_str(), ios::out | ios::app );
+    if (!fout.good())
+        return;
+
+    fout << "---- Tick " << TickCount << " ----\n";
+    WriteMemoryReport( fout, *Context );
+    fout << '\n';
+}
+
+void GLUTApp::QueueInputEvent( const InputEvent &Event )
+{
+    // A full queue means the consumer has stalled for over a thousand events, dropping the
+    // newest is preferable to blocking the windowing thread
+    InputEvents->TryPush( Event );
+}
+
+void GLUTApp::DrainInputEvents()
+{
+    InputEvent Event;
+    while (InputEvents->TryPop( Event ))
+        Context->Input.Apply( Event );
 }
 
 void GLUTApp::OnKeyPress( unsigned char Key )
@@ -221,12 +489,17 @@ void GLUTApp::OnKeyPress( unsigned char Key )
     if (Key == 27)
         Exit();
 
-	PressedSet->insert( Key );
+    // Everything else is handled by OnUpdate() from the drained input
+    InputEvent Event( InputEvent::KeyPress, Profiler::GetTicks() );
+    Event.Code = Key;
+    QueueInputEvent( Event );
 }
 
 void GLUTApp::OnKeyRelease( unsigned char KeyReleased )
 {
-	PressedSet->erase( KeyReleased );
+    InputEvent Event( InputEvent::KeyRelease, Profiler::GetTicks() );
+    Event.Code = KeyReleased;
+    QueueInputEvent( Event );
 }
 
 void GLUTApp::OnMouseMotion( int MouseX, int MouseY )
@@ -237,8 +510,10 @@ void GLUTApp::OnMouseMotion( int MouseX, int MouseY )
     // Current position of mouse
     Vector2f CurPos( (float)MouseX/WindowWidth, (float)MouseY/WindowHeight );
 
-    // Push the difference onto the queue
-    MotionQueue->push( CurPos - PrevPos );
+    // Queue the difference
+    InputEvent Event( InputEvent::MouseMotion, Profiler::GetTicks() );
+    Event.Motion = CurPos - PrevPos;
+    QueueInputEvent( Event );
 
     // Save current position
     PrevPos = CurPos;
@@ -254,7 +529,9 @@ void GLUTApp::OnMouseMotion( int MouseX, int MouseY )
 
 void GLUTApp::OnMousePress( int Button )
 {
-    ButtonQueue->push( Button );
+    InputEvent Event( InputEvent::MousePress, Profiler::GetTicks() );
+    Event.Code = Button;
+    QueueInputEvent( Event );
 }
 
 void GLUTApp::OnChangeSize( int Width, int Height )
@@ -271,16 +548,20 @@ void GLUTApp::OnChangeSize( int Width, int Height )
 
 void GLUTApp::RenderText( RenderTextData *TextData )
 {
-    TextToRender->push( TextData );
+    TextToRender->push_back( TextData );
 }
 
 void GLUTApp::RenderTextQueue()
 {
-    if (TextToRender->size() == 0)
+    if (TextToRender->empty())
         return;
 
-    for (RenderTextData *TextData = TextToRender->front(); !TextToRender->empty(); TextToRender->pop())
+    PROFILE_COUNT( "DrawCalls", TextToRender->size() );
+
+    for (unsigned int i = 0; i < TextToRender->size(); i++)
     {
+        const RenderTextData *TextData = (*TextToRender)[i];
+
         // Push identity matrix onto projection matrix stack
         glMatrixMode( GL_PROJECTION );
         glPushMatrix();
@@ -313,16 +594,18 @@ void GLUTApp::RenderTextQueue()
 
 void GLUTApp::ApplyGLPerspectiveMatrix()
 {
-    // Get pointer to current camera
-    const Camera *CurCamera = Singleton<Camera *>::Instance();
+    // Set the view port to the entire window
+    glViewport( 0, 0, WindowWidth, WindowHeight );
+
+    // Get pointer to current camera, states without one only render text
+    const Camera *CurCamera = Context->CurrentCamera;
+    if (CurCamera == NULL)
+        return;
 
     // Set projection matrix to identity
     glMatrixMode( GL_PROJECTION );
     glLoadIdentity();
 
-    // Set the view port to the entire window
-    glViewport( 0, 0, WindowWidth, WindowHeight );
-
     // Set projection matrix
     gluPerspective( CurCamera->GetFOVY(), (double)WindowWidth/WindowHeight, CurCamera->GetNearClip(), CurCamera->GetFarClip() );
 }
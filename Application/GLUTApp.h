@@ -9,15 +9,19 @@
 
 // C++ standard library & STL
 #include <string>
-#include <stack>
-#include <queue>
-#include <set>
+#include <vector>
 
 // Windows
 #include <Windows.h>
 
 // Utilities
 #include "..\Utilities\Matrix.h"
+#include "..\Utilities\SPSCQueue.h"
+#include "..\Utilities\FrameArena.h"
+#include "..\Utilities\HashedID.h"
+
+#include "..\EngineContext.h"
+#include "..\InputState.h"
 
 
 // ------------------------------------------------------------------------------------
@@ -48,44 +52,107 @@ struct RenderTextData
 //   destructors are never called. Therefore, all data is dynamically allocated and
 //   manually freed in Destroy().
 class IGameState;
+class GameStatePool;
+class SettingFile;
+class FileWatcher;
 class PerformanceTimer;
-class GLUTApp
+class PerformanceHUD;
+class TelemetryPublisher;
+class GLUTApp : public IAppServices
 {
 public:
     int Run( const std::string &SettingsPath, HINSTANCE hInstance, char *CommandLine, int ShowCommand );
 	void Exit();
 
     // Accessors
-    inline std::queue<Vector2f> &GetMouseMotion();
-    inline std::queue<int> &GetPressedMouseButtons();
-    inline std::set<unsigned char> GetPressedKeys();
+    inline EngineContext &GetContext();
 	inline int GetWindowWidth() const;
 	inline int GetWindowHeight() const;
 
-    // Change game state
-	void PushState( const std::string &StateID );
+    // Change game state. States come from, and return to, a pool of prewarmed instances.
+	void PushState( const HashedID &StateID );
     void PopState();
     
     // Text rendering
     void RenderText( RenderTextData *TextData );
 
 private:
-    std::stack<IGameState *> *StateStack;
+    // Active states, the last one is current. Each remembers the ID it was pooled under.
+    struct StateStackEntry
+    {
+        IGameState *State;
+        HashedID ID;
+    };
+    std::vector<StateStackEntry> *StateStack;
+    GameStatePool *States;
+
+    // Camera, random generator & input handed to the game states
+    EngineContext *Context;
+
+    // Settings the app was started with. With SettingsHotReload set they are reloaded
+    // between ticks whenever SettingsWatcher sees the file change.
+    SettingFile *Settings;
+    FileWatcher *SettingsWatcher;
+    // Why the last reload failed, shown until a reload succeeds
+    RenderTextData *SettingsError;
+
+    // Input events from the GLUT callbacks, drained into Context->Input once per update.
+    // The callbacks are the only producer and OnUpdate() the only consumer, so the two
+    // may run on different threads.
+    typedef SPSCQueue<InputEvent, 1024> InputEventQueue;
+    InputEventQueue *InputEvents;
 
     PerformanceTimer *UpdateTimer;
+    PerformanceHUD *HUD;
     int WindowWidth, WindowHeight;
 
-    std::queue<RenderTextData *> *TextToRender;
+    // Transient allocations, reset every other frame
+    FrameArena *FrameMemory;
+
+    // Text queued this frame, lives in FrameMemory
+    typedef std::vector<RenderTextData *, FrameAllocator<RenderTextData *> > TextList;
+    TextList *TextToRender;
+
+    // Profile report written on exit, empty if profiling output is disabled
+    std::string *ProfileReportPath;
+
+    // Memory reports are appended here on the M key, and on exit if the setting is present
+    std::string *MemoryReportPath;
+    bool MemoryReportOnExit;
+
+    // Live per-tick telemetry for external monitors
+    TelemetryPublisher *Telemetry;
+    long long TelemetryStartTicks;
+    unsigned long long TelemetryMemoryBytes;
 
-    // User input queues
-    std::queue<Vector2f> *MotionQueue;
-    std::queue<int> *ButtonQueue;
-	std::set<unsigned char> *PressedSet;
+    // Allocation tracking, see Utilities\AllocationTracker.h. Heap allocations inside a tick
+    // are flagged once TickCount reaches AllocationCheckAfterTicks, 0 disables the check.
+    unsigned long long TickCount, LastTickAllocations;
+    unsigned long long AllocationCheckAfterTicks;
 
 
     // Frees all allocated memory
     void Destroy();
 
+    // Publish the previous frame's measurements to the telemetry ring
+    void PublishTelemetry( float FrameSeconds );
+
+    // Append a memory report to MemoryReportPath
+    void AppendMemoryReport();
+
+    // Switch to a fresh frame arena buffer and recreate per-frame containers in it
+    void BeginFrameMemory();
+
+    // Input event handling
+    void QueueInputEvent( const InputEvent &Event );
+    void DrainInputEvents();
+
+    // Return finished states anywhere in the stack to the pool
+    void ReleaseFinishedStates();
+
+    // Reload the settings file and hand it to every state in the stack
+    void ReloadSettings();
+
     // Rendering methods
     void RenderTextQueue();
     void ApplyGLPerspectiveMatrix();
@@ -112,19 +179,9 @@ private:
 // -----------------------------Inline function definitions----------------------------
 // ------------------------------------------------------------------------------------
 
-std::queue<Vector2f> &GLUTApp::GetMouseMotion()
-{
-    return *MotionQueue;
-}
-
-std::queue<int> &GLUTApp::GetPressedMouseButtons()
-{
-    return *ButtonQueue;
-}
-
-std::set<unsigned char> GLUTApp::GetPressedKeys()
+EngineContext &GLUTApp::GetContext()
 {
-    return *PressedSet;
+    return *Context;
 }
 
 int GLUTApp::GetWindowWidth() const
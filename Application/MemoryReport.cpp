@@ -0,0 +1,76 @@
+// ------------------------------------------------------------------------------------
+// ----------------------------------Included headers----------------------------------
+// ------------------------------------------------------------------------------------
+#include "MemoryReport.h"
+
+// C++ standard library
+#include <ostream>
+#include <iomanip>
+using namespace std;
+
+// Utilities
+#include "..\Utilities\MemoryStats.h"
+#include "..\Utilities\AllocationTracker.h"
+#include "..\Utilities\ObjectPool.h"
+#include "..\Utilities\Profiler.h"
+#include "..\Utilities\Singleton.h"
+
+#include "..\EngineContext.h"
+#include "..\Snake3DObjects.h"
+
+
+// ------------------------------------------------------------------------------------
+// --------------------------------Function definitions--------------------------------
+// ------------------------------------------------------------------------------------
+
+void WriteMemoryReport( ostream &Out, const EngineContext &Context )
+{
+    unsigned long long Resident = GetResidentBytes(),
+                       PeakResident = GetPeakResidentBytes();
+
+    Out << "Memory report\n" << fixed << setprecision(1);
+    Out << "Resident " << Resident/1024.0 << " KB, peak " << PeakResident/1024.0 << " KB\n";
+
+    // Live heap per subsystem
+    if (AllocationTracker::IsEnabled())
+    {
+        unsigned long long LiveBytes = 0, LiveBlocks = 0;
+        for (int i = 0; i < AllocationTracker::GetNumTags(); i++)
+        {
+            AllocationStats Stats = AllocationTracker::GetTagStats( i );
+            LiveBytes += Stats.LiveBytes;
+            LiveBlocks += Stats.Allocations - Stats.Frees;
+        }
+
+        Out << "Tracked heap " << LiveBytes/1024.0 << " KB live in " << LiveBlocks << " blocks\n";
+
+        // Whatever the resident set holds beyond live heap blocks is code, stacks, untracked
+        // allocations and heap fragmentation
+        if (Resident > LiveBytes)
+            Out << "Untracked or fragmented " << (Resident - LiveBytes)/1024.0 << " KB ("
+                << 100.0 * (Resident - LiveBytes)/Resident << "% of resident)\n";
+
+        Out << '\n';
+        AllocationTracker::WriteReport( Out );
+    }
+    else
+        Out << "Live heap per subsystem: n/a, build with TRACK_ALLOCATIONS\n";
+
+    // Free-standing segment storage, free slots are internal fragmentation of the pool
+    const ObjectPool<SnakeSegment> &Pool = *Context.SegmentPool;
+    unsigned int Capacity = Pool.GetCapacity(), Live = Pool.GetLiveCount();
+    Out << "\nSegment pool " << Live << " of " << Capacity << " slots live in " << Pool.GetChunkCount()
+        << " chunks, " << Pool.GetReservedBytes()/1024.0 << " KB reserved, "
+        << (Capacity > 0 ? 100.0 * (Capacity - Live)/Capacity : 0.0) << "% free\n";
+
+    // Snake bodies as of the last update, unused capacity is the price of amortized growth
+    Profiler &Prof = Singleton<Profiler>::Instance();
+    static const int SegmentCounter = Prof.RegisterCounter( "SnakeSegments" ),
+                     BufferCounter = Prof.RegisterCounter( "SnakeBufferBytes" );
+    unsigned long long Segments = Prof.GetLastFrameCount( SegmentCounter ),
+                       BufferBytes = Prof.GetLastFrameCount( BufferCounter ),
+                       SegmentBytes = Segments * Snake::BytesPerSegment;
+    Out << "Snake body " << Segments << " segments of " << Snake::BytesPerSegment << " bytes in "
+        << BufferBytes/1024.0 << " KB of streams and indices, "
+        << (BufferBytes > 0 ? 100.0 * (BufferBytes - SegmentBytes)/BufferBytes : 0.0) << "% unused\n";
+}
\ No newline at end of file
@@ -0,0 +1,26 @@
+#ifndef MEMORYREPORT_H
+#define MEMORYREPORT_H
+
+
+
+// ------------------------------------------------------------------------------------
+// ----------------------------------Included headers----------------------------------
+// ------------------------------------------------------------------------------------
+
+// C++ standard library
+#include <ostream>
+
+
+// ------------------------------------------------------------------------------------
+// ---------------------------------Function prototypes--------------------------------
+// ------------------------------------------------------------------------------------
+
+// Write the process footprint: resident and peak resident memory, live heap bytes per
+// allocation tag (TRACK_ALLOCATIONS builds only), segment pool usage and fragmentation,
+// and the estimated cost of each snake segment.
+struct EngineContext;
+void WriteMemoryReport( std::ostream &Out, const EngineContext &Context );
+
+
+
+#endif
\ No newline at end of file
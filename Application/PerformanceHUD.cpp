@@ -0,0 +1,157 @@
+// ------------------------------------------------------------------------------------
+// ----------------------------------Included headers----------------------------------
+// ------------------------------------------------------------------------------------
+#include "PerformanceHUD.h"
+
+// C standard library
+#include <cstdio>
+
+// C++ standard library & STL
+#include <algorithm>
+using namespace std;
+
+// Windows/OpenGL
+#include <Windows.h>
+#include <gl/GL.h>
+#include <gl/glut.h>
+
+// Utilities
+#include "..\Utilities\Singleton.h"
+#include "..\Utilities\Profiler.h"
+#include "..\Utilities\AllocationTracker.h"
+
+#include "GLUTApp.h"
+
+
+// ------------------------------------------------------------------------------------
+// ----------------------------------Helper functions----------------------------------
+// ------------------------------------------------------------------------------------
+
+// Last frame time of a zone in milliseconds, 0 if the zone has not run yet
+static float GetZoneMilliseconds( const Profiler &Prof, const char *Name )
+{
+    int ZoneID = Prof.FindZone( Name );
+    return ZoneID >= 0 ? static_cast<float>(Prof.GetLastFrameSeconds( ZoneID ) * 1000) : 0;
+}
+
+// Format a counter's last frame value, or n/a if nothing has reported it
+static void FormatCount( const Profiler &Prof, const char *Name, char *Buffer, int BufferSize )
+{
+    int CounterID = Prof.FindCounter( Name );
+    if (CounterID >= 0)
+        snprintf( Buffer, BufferSize, "%lld", Prof.GetLastFrameCount( CounterID ) );
+    else
+        snprintf( Buffer, BufferSize, "n/a" );
+}
+
+
+// ------------------------------------------------------------------------------------
+// -------------------------------PerformanceHUD Members-------------------------------
+// ------------------------------------------------------------------------------------
+
+PerformanceHUD::PerformanceHUD()
+: NextFrame(0), NumFrames(0), RefreshInterval(0.25f), SinceRefresh(0),
+  CurrentFrameTime(0), P99FrameTime(0), Visible(false)
+{
+    for (int i = 0; i < NUM_LINES; i++)
+    {
+        Lines[i].Position = Vector2f( 10, 20 + 15.0f * i );
+        Lines[i].Color = Color3f( 0, 0, 0 );
+        Lines[i].GLUTFont = GLUT_BITMAP_8_BY_13;
+
+        // Reserve up front so refreshing the text never reallocates
+        Lines[i].Text.reserve( 128 );
+    }
+}
+
+void PerformanceHUD::AddFrameTime( float FrameSeconds )
+{
+    FrameTimes[NextFrame] = FrameSeconds;
+    NextFrame = (NextFrame + 1) % HISTORY_SIZE;
+    if (NumFrames < HISTORY_SIZE)
+        NumFrames++;
+
+    CurrentFrameTime = FrameSeconds;
+
+    // Statistics are gathered even while hidden so they are valid as soon as the HUD is shown
+    SinceRefresh += FrameSeconds;
+    if (Visible && SinceRefresh >= RefreshInterval)
+    {
+        Refresh();
+        SinceRefresh = 0;
+    }
+}
+
+void PerformanceHUD::Render( GLUTApp &App )
+{
+    if (!Visible)
+        return;
+
+    for (int i = 0; i < NUM_LINES; i++)
+    {
+        if (!Lines[i].Text.empty())
+            App.RenderText( &Lines[i] );
+    }
+}
+
+void PerformanceHUD::Refresh()
+{
+    ALLOCATION_TAG( "PerformanceHUD" );
+
+    const Profiler &Prof = Singleton<Profiler>::Instance();
+    char Buffer[128], Count[32];
+
+    RefreshP99();
+
+    float FrameMS = CurrentFrameTime * 1000;
+    snprintf( Buffer, sizeof(Buffer), "FPS %.0f  frame %.2f ms  p99 %.2f ms",
+              CurrentFrameTime > 0 ? 1/CurrentFrameTime : 0, FrameMS, P99FrameTime * 1000 );
+    Lines[0].Text.assign( Buffer );
+
+    snprintf( Buffer, sizeof(Buffer), "Update %.2f ms  Render %.2f ms",
+              GetZoneMilliseconds( Prof, "Update" ), GetZoneMilliseconds( Prof, "Render" ) );
+    Lines[1].Text.assign( Buffer );
+
+    snprintf( Buffer, sizeof(Buffer), "  snake %.2f ms  collision %.2f ms  snake render %.2f ms",
+              GetZoneMilliseconds( Prof, "Snake::Update" ), GetZoneMilliseconds( Prof, "Snake::IsSelfColliding" ),
+              GetZoneMilliseconds( Prof, "Snake::Render" ) );
+    Lines[2].Text.assign( Buffer );
+
+    FormatCount( Prof, "SnakeSegments", Count, sizeof(Count) );
+    snprintf( Buffer, sizeof(Buffer), "Segments %s", Count );
+    Lines[3].Text.assign( Buffer );
+
+    FormatCount( Prof, "CollisionTests", Count, sizeof(Count) );
+    snprintf( Buffer, sizeof(Buffer), "Collision tests/tick %s", Count );
+    Lines[4].Text.assign( Buffer );
+
+    char ArenaCount[32];
+    FormatCount( Prof, "Allocations", Count, sizeof(Count) );
+    FormatCount( Prof, "FrameArenaBytes", ArenaCount, sizeof(ArenaCount) );
+    snprintf( Buffer, sizeof(Buffer), "Allocations/frame %s  frame arena %s bytes", Count, ArenaCount );
+    Lines[5].Text.assign( Buffer );
+
+    FormatCount( Prof, "DrawCalls", Count, sizeof(Count) );
+    snprintf( Buffer, sizeof(Buffer), "Draw calls %s", Count );
+    Lines[6].Text.assign( Buffer );
+}
+
+void PerformanceHUD::RefreshP99()
+{
+    if (NumFrames == 0)
+    {
+        P99FrameTime = 0;
+        return;
+    }
+
+    // Partial sort of a copy of the history, only the 99th percentile element is placed
+    float Sorted[HISTORY_SIZE];
+    copy( FrameTimes, FrameTimes + NumFrames, Sorted );
+
+    int Index = (NumFrames * 99) / 100;
+    if (Index >= NumFrames)
+        Index = NumFrames - 1;
+
+    nth_element( Sorted, Sorted + Index, Sorted + NumFrames );
+    P99FrameTime = Sorted[Index];
+}
\ No newline at end of file
@@ -0,0 +1,81 @@
+#ifndef PERFORMANCEHUD_H
+#define PERFORMANCEHUD_H
+
+
+
+// ------------------------------------------------------------------------------------
+// ----------------------------------Included headers----------------------------------
+// ------------------------------------------------------------------------------------
+
+// Application
+#include "GLUTApp.h"
+
+
+// ------------------------------------------------------------------------------------
+// ---------------------------------------Classes--------------------------------------
+// ------------------------------------------------------------------------------------
+
+// Toggleable overlay of runtime statistics gathered by the profiler.
+// Text is formatted into preallocated RenderTextData lines, and the p99 frame time is
+// only recomputed a few times a second, so leaving the HUD on costs next to nothing.
+class PerformanceHUD
+{
+public:
+    PerformanceHUD();
+
+    // Accessors
+    inline bool IsVisible() const;
+
+    // Modifiers
+    inline void SetVisible( bool visible );
+    inline void Toggle();
+
+    // Record the duration of the frame that just finished
+    void AddFrameTime( float FrameSeconds );
+
+    // Queue the HUD text for rendering
+    void Render( GLUTApp &App );
+
+private:
+    enum { HISTORY_SIZE = 256, NUM_LINES = 7 };
+
+    // Ring buffer of recent frame times
+    float FrameTimes[HISTORY_SIZE];
+    int NextFrame, NumFrames;
+
+    // Statistics refreshed every RefreshInterval seconds
+    float RefreshInterval, SinceRefresh;
+    float CurrentFrameTime, P99FrameTime;
+
+    RenderTextData Lines[NUM_LINES];
+    bool Visible;
+
+
+    // Recompute cached statistics and line text
+    void Refresh();
+    void RefreshP99();
+};
+
+
+// ------------------------------------------------------------------------------------
+// -----------------------------Inline function definitions----------------------------
+// ------------------------------------------------------------------------------------
+
+bool PerformanceHUD::IsVisible() const
+{
+    return Visible;
+}
+
+void PerformanceHUD::SetVisible( bool visible )
+{
+    Visible = visible;
+}
+
+void PerformanceHUD::Toggle()
+{
+    Visible = !Visible;
+}
+
+
+
+#endif
\ No newline at end of file
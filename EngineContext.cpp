@@ -0,0 +1,37 @@
+// ------------------------------------------------------------------------------------
+// ----------------------------------Included headers----------------------------------
+// ------------------------------------------------------------------------------------
+#include "EngineContext.h"
+
+// C++ standard library
+#include <string>
+using namespace std;
+
+// Utilities
+#include "Utilities\Singleton.h"
+#include "Utilities\Factory.h"
+
+#include "IGameState.h"
+#include "Snake3DObjects.h"
+
+
+// ------------------------------------------------------------------------------------
+// -------------------------------EngineContext Members--------------------------------
+// ------------------------------------------------------------------------------------
+
+EngineContext::EngineContext( IAppServices &App )
+: App(App), CurrentCamera(NULL), FrameMemory(NULL), Settings(NULL), StateFactory(Singleton<StateFactoryType>::Instance())
+{
+    SegmentPool = new ObjectPool<SnakeSegment>;
+}
+
+EngineContext::EngineContext( IAppServices &App, unsigned long Seed )
+: App(App), CurrentCamera(NULL), Random(Seed), FrameMemory(NULL), Settings(NULL), StateFactory(Singleton<StateFactoryType>::Instance())
+{
+    SegmentPool = new ObjectPool<SnakeSegment>;
+}
+
+EngineContext::~EngineContext()
+{
+    delete SegmentPool;
+}
\ No newline at end of file
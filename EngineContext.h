@@ -0,0 +1,97 @@
+#ifndef ENGINECONTEXT_H
+#define ENGINECONTEXT_H
+
+
+
+// ------------------------------------------------------------------------------------
+// ----------------------------------Included headers----------------------------------
+// ------------------------------------------------------------------------------------
+
+// C++ standard library
+#include <string>
+
+// Utilities
+#include "Utilities\Singleton.h"
+#include "Utilities\Factory.h"
+#include "Utilities\HashedID.h"
+#include "Utilities\Matrix.h"
+#include "Utilities\MersenneTwister.h"
+#include "Utilities\ObjectPool.h"
+
+#include "InputState.h"
+
+
+// ------------------------------------------------------------------------------------
+// --------------------------------------Interfaces------------------------------------
+// ------------------------------------------------------------------------------------
+
+// Services a game state needs from whatever is hosting it. GLUTApp implements this for
+// the interactive game, a headless host can implement it to run worlds without a window.
+struct RenderTextData;
+class IAppServices
+{
+public:
+    virtual ~IAppServices() {}
+
+    // Change game state
+    virtual void PushState( const HashedID &StateID ) = 0;
+
+    // Queue text for rendering this frame, TextData must outlive the frame
+    virtual void RenderText( RenderTextData *TextData ) = 0;
+
+    virtual int GetWindowWidth() const = 0;
+    virtual int GetWindowHeight() const = 0;
+};
+
+
+// ------------------------------------------------------------------------------------
+// --------------------------------------Structures------------------------------------
+// ------------------------------------------------------------------------------------
+
+// Everything a game state may touch outside of itself. Each running game owns one
+// context, so any number of games can share a process without sharing state.
+class IGameState;
+class Camera;
+class FrameArena;
+class SnakeSegment;
+class SettingFile;
+struct EngineContext
+{
+    typedef Factory<IGameState, HashedID> StateFactoryType;
+
+    // Constructors - The generator is seeded with the current time unless a seed is given
+    EngineContext( IAppServices &App );
+    EngineContext( IAppServices &App, unsigned long Seed );
+    ~EngineContext();
+
+    IAppServices &App;
+
+    // Camera used for rendering, owned by the state that set it
+    Camera *CurrentCamera;
+
+    MersenneTwister Random;
+    InputState Input;
+
+    // Scratch memory valid for the current and the next frame, NULL if the host has none
+    FrameArena *FrameMemory;
+
+    // Settings the host was started with, NULL if it has none. States read them in Init(),
+    // and are handed them again through ApplySettings() when the host reloads them.
+    const SettingFile *Settings;
+
+    // Storage for free-standing segments such as food, snake bodies hold their own. Kept
+    // here rather than in a world so any number of worlds share the memory.
+    ObjectPool<SnakeSegment> *SegmentPool;
+
+    // Game state types, registered once at static initialization and shared by all contexts
+    StateFactoryType &StateFactory;
+
+private:
+    // Disable copying
+    EngineContext( const EngineContext & );
+    EngineContext &operator = ( const EngineContext & );
+};
+
+
+
+#endif
\ No newline at end of file
@@ -0,0 +1,87 @@
+// ------------------------------------------------------------------------------------
+// ----------------------------------Included headers----------------------------------
+// ------------------------------------------------------------------------------------
+#include "GameStatePool.h"
+
+// STL
+#include <vector>
+using namespace std;
+
+// Utilities
+#include "Utilities\HashedID.h"
+
+#include "IGameState.h"
+#include "EngineContext.h"
+
+
+// ------------------------------------------------------------------------------------
+// --------------------------------GameStatePool Members-------------------------------
+// ------------------------------------------------------------------------------------
+
+GameStatePool::GameStatePool( EngineContext &Context )
+: Context(Context)
+{
+    Idle.reserve( 8 );
+}
+
+GameStatePool::~GameStatePool()
+{
+    for (unsigned int i = 0; i < Idle.size(); i++)
+    {
+        for (unsigned int j = 0; j < Idle[i].States.size(); j++)
+            delete Idle[i].States[j];
+    }
+}
+
+void GameStatePool::Prewarm( int Count )
+{
+    vector<HashedID> IDs = Context.StateFactory.GetRegisteredIDs();
+    for (unsigned int i = 0; i < IDs.size(); i++)
+    {
+        IdleStates &List = GetIdleStates( IDs[i] );
+        for (int j = static_cast<int>(List.States.size()); j < Count; j++)
+            List.States.push_back( IGameState::New( Context, IDs[i] ) );
+    }
+}
+
+IGameState *GameStatePool::Acquire( const HashedID &ID )
+{
+    IdleStates &List = GetIdleStates( ID );
+
+    IGameState *State;
+    if (!List.States.empty())
+    {
+        State = List.States.back();
+        List.States.pop_back();
+    }
+    else
+    {
+        State = IGameState::New( Context, ID );
+        if (State == NULL)
+            return NULL;
+    }
+
+    State->Init( Context );
+    return State;
+}
+
+void GameStatePool::Release( const HashedID &ID, IGameState *State )
+{
+    State->DeInit();
+    GetIdleStates( ID ).States.push_back( State );
+}
+
+GameStatePool::IdleStates &GameStatePool::GetIdleStates( const HashedID &ID )
+{
+    for (unsigned int i = 0; i < Idle.size(); i++)
+    {
+        if (Idle[i].Hash == ID.GetHash())
+            return Idle[i];
+    }
+
+    // First use of this type, leave room so releases don't reallocate
+    Idle.push_back( IdleStates() );
+    Idle.back().Hash = ID.GetHash();
+    Idle.back().States.reserve( 4 );
+    return Idle.back();
+}
\ No newline at end of file
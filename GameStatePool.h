@@ -0,0 +1,64 @@
+#ifndef GAMESTATEPOOL_H
+#define GAMESTATEPOOL_H
+
+
+
+// ------------------------------------------------------------------------------------
+// ----------------------------------Included headers----------------------------------
+// ------------------------------------------------------------------------------------
+
+// STL
+#include <vector>
+
+// Utilities
+#include "Utilities\HashedID.h"
+
+
+// ------------------------------------------------------------------------------------
+// ---------------------------------------Classes--------------------------------------
+// ------------------------------------------------------------------------------------
+
+// Keeps game states alive between uses.
+// States are constructed once, ahead of time by Prewarm() or on first use, and cycle
+// through Init()/DeInit() afterwards. Constructors should allocate whatever a state needs
+// so that Init() doesn't have to, making transitions allocation free.
+struct EngineContext;
+class IGameState;
+class GameStatePool
+{
+public:
+    GameStatePool( EngineContext &Context );
+    ~GameStatePool();
+
+    // Construct Count idle instances of every state registered with the context's factory
+    void Prewarm( int Count = 1 );
+
+    // Get an initialized state, constructing one only if none of that type is idle.
+    // Returns NULL if the ID is not registered.
+    IGameState *Acquire( const HashedID &ID );
+
+    // DeInit a state acquired with ID and keep it for reuse
+    void Release( const HashedID &ID, IGameState *State );
+
+private:
+    // Idle instances of one state type. There are few types, so they are searched linearly.
+    struct IdleStates
+    {
+        unsigned int Hash;
+        std::vector<IGameState *> States;
+    };
+
+    EngineContext &Context;
+    std::vector<IdleStates> Idle;
+
+
+    IdleStates &GetIdleStates( const HashedID &ID );
+
+    // Disable copying
+    GameStatePool( const GameStatePool & );
+    GameStatePool &operator = ( const GameStatePool & );
+};
+
+
+
+#endif
\ No newline at end of file
@@ -3,19 +3,18 @@
 // ------------------------------------------------------------------------------------
 #include "IGameState.h"
 
-// C++ standard library
-#include <string>
-using namespace std;
-
 // Utilities
 #include "Utilities\Singleton.h"
 #include "Utilities\Factory.h"
+#include "Utilities\HashedID.h"
+
+#include "EngineContext.h"
 
 
 // ------------------------------------------------------------------------------------
 // -----------------------------IGameState Factory Method------------------------------
 // ------------------------------------------------------------------------------------
-IGameState *IGameState::New( const string &ID )
+IGameState *IGameState::New( EngineContext &Context, const HashedID &ID )
 {
-    return Singleton<Factory<IGameState, string>>::Instance().CreateProduct( ID );
+    return Context.StateFactory.CreateProduct( ID );
 }
\ No newline at end of file
@@ -6,18 +6,24 @@
 // ----------------------------------Included headers----------------------------------
 // ------------------------------------------------------------------------------------
 
-// C++ standard library
-#include <string>
+// Utilities
+#include "Utilities\HashedID.h"
 
 
 // ------------------------------------------------------------------------------------
 // --------------------------------------Interfaces------------------------------------
 // ------------------------------------------------------------------------------------
 
+struct EngineContext;
+class SettingFile;
 class IGameState
 {
 public:
-    virtual void Init() = 0;
+    // States are deleted through this interface by the pool
+    virtual ~IGameState() {}
+
+    // Context is owned by the host and outlives the state
+    virtual void Init( EngineContext &Context ) = 0;
     virtual void DeInit() = 0;
 
     virtual void Update( float ElapsedTime ) = 0;
@@ -25,8 +31,12 @@ public:
 
     virtual bool IsFinished() = 0;
 
+    // Settings were reloaded, pick up whatever may change while running. Called between
+    // ticks on every state in the stack.
+    virtual void ApplySettings( const SettingFile &Settings ) {}
+
     // Factory method
-    static IGameState *New( const std::string &ID );
+    static IGameState *New( EngineContext &Context, const HashedID &ID );
 };
 
 
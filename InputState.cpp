@@ -0,0 +1,62 @@
+// ------------------------------------------------------------------------------------
+// ----------------------------------Included headers----------------------------------
+// ------------------------------------------------------------------------------------
+#include "InputState.h"
+
+// Utilities
+#include "Utilities\Matrix.h"
+
+
+// ------------------------------------------------------------------------------------
+// ---------------------------------InputEvent Members---------------------------------
+// ------------------------------------------------------------------------------------
+
+InputEvent::InputEvent()
+: Type(KeyPress), Ticks(0), Code(0), Motion(0)
+{
+}
+
+InputEvent::InputEvent( EventType Type, long long Ticks )
+: Type(Type), Ticks(Ticks), Code(0), Motion(0)
+{
+}
+
+
+// ------------------------------------------------------------------------------------
+// ---------------------------------InputState Members---------------------------------
+// ------------------------------------------------------------------------------------
+
+InputState::InputState()
+{
+    Clear();
+}
+
+void InputState::Apply( const InputEvent &Event )
+{
+    switch (Event.Type)
+    {
+    case InputEvent::KeyPress:
+        PressedKeys.set( Event.Code & 0xFF );
+        break;
+
+    case InputEvent::KeyRelease:
+        PressedKeys.reset( Event.Code & 0xFF );
+        break;
+
+    case InputEvent::MouseMotion:
+        MouseMotion += Event.Motion;
+        break;
+
+    case InputEvent::MousePress:
+        if (NumPressedButtons < MaxButtonPresses)
+            PressedButtons[NumPressedButtons++] = Event.Code;
+        break;
+    }
+}
+
+void InputState::Clear()
+{
+    PressedKeys.reset();
+    MouseMotion = Vector2f(0);
+    NumPressedButtons = 0;
+}
\ No newline at end of file
@@ -0,0 +1,88 @@
+#ifndef INPUTSTATE_H
+#define INPUTSTATE_H
+
+
+
+// ------------------------------------------------------------------------------------
+// ----------------------------------Included headers----------------------------------
+// ------------------------------------------------------------------------------------
+
+// C++ standard library
+#include <bitset>
+
+// Utilities
+#include "Utilities\Matrix.h"
+
+
+// ------------------------------------------------------------------------------------
+// --------------------------------------Structures------------------------------------
+// ------------------------------------------------------------------------------------
+
+// Single input event as captured by the windowing callbacks
+struct InputEvent
+{
+    enum EventType
+    {
+        KeyPress,
+        KeyRelease,
+        MouseMotion,
+        MousePress
+    };
+
+    // Constructors
+    InputEvent();
+    InputEvent( EventType Type, long long Ticks );
+
+    EventType Type;
+
+    // Capture time, in Profiler::GetTicks() units
+    long long Ticks;
+
+    // Key for key events, button for mouse presses
+    int Code;
+
+    // Movement in window fractions for mouse motion
+    Vector2f Motion;
+};
+
+// User input gathered since the last update, built by applying input events in order.
+// Fixed size, so no event burst can cause an allocation.
+struct InputState
+{
+    static const int MaxButtonPresses = 8;
+
+    InputState();
+
+    // Fold an event into the state
+    void Apply( const InputEvent &Event );
+
+    // Forget everything gathered for the frame
+    void Clear();
+
+    // Accessors
+    inline bool IsKeyPressed( unsigned char Key ) const;
+
+    // Keys pressed this frame and not released since
+    std::bitset<256> PressedKeys;
+
+    // Sum of all mouse movement this frame
+    Vector2f MouseMotion;
+
+    // Mouse buttons pressed this frame, in order. Presses past the limit are dropped.
+    int PressedButtons[MaxButtonPresses];
+    int NumPressedButtons;
+};
+
+
+// ------------------------------------------------------------------------------------
+// -----------------------------Inline function definitions----------------------------
+// ------------------------------------------------------------------------------------
+
+bool InputState::IsKeyPressed( unsigned char Key ) const
+{
+    return PressedKeys.test( Key );
+}
+
+
+
+#endif
\ No newline at end of file
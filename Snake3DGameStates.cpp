@@ -3,9 +3,8 @@
 // ------------------------------------------------------------------------------------
 #include "Snake3DGameStates.h"
 
-// STL
-#include <queue>
-#include <set>
+// C++ standard library
+#include <string>
 using namespace std;
 
 // Windows/OpenGL
@@ -18,9 +17,14 @@ using namespace std;
 #include "Utilities\Singleton.h"
 #include "Utilities\Matrix.h"
 #include "Utilities\Rand Utilities.h"
+#include "Utilities\Profiler.h"
+#include "Utilities\AllocationTracker.h"
+#include "Utilities\SettingFile.h"
+#include "Utilities\Intersection.h"
 
 #include "Application\GLUTApp.h"
 #include "IGameState.h"
+#include "EngineContext.h"
 #include "Snake3DObjects.h"
 #include "Camera.h"
 
@@ -30,99 +34,162 @@ using namespace std;
 // ------------------------------------------------------------------------------------
 
 // Set type ID for IGameState factory
-FactoryRegistrar<IGameState, Snake3DGameWorld, std::string> Snake3DGameWorld::Registrar( "Snake3DGameWorld" );
+FactoryRegistrar<IGameState, Snake3DGameWorld, HashedID> Snake3DGameWorld::Registrar( Snake3DGameWorld::ID );
 
 
 Snake3DGameWorld::Snake3DGameWorld()
 {
 	Initialized = false;
+
+    // Game objects are created on the first Init(), which brings the segment pool
+    Context = NULL;
+    snake = NULL;
+    snakeFood = NULL;
+    camera = NULL;
 }
 
 Snake3DGameWorld::~Snake3DGameWorld()
 {
 	DeInit();
+
+    if (snake != NULL)
+    {
+        delete snake;
+        Context->SegmentPool->Delete( snakeFood );
+        delete camera;
+    }
 }
 
-void Snake3DGameWorld::Init()
+void Snake3DGameWorld::Init( EngineContext &Context )
 {
-    // Create game objects
-    EnvSphereSize = 60;
-    snake = new Snake( Vector3f(0, 0, 0), Vector3f(1, 0, 0), 0.01f, 40, 1.0f );
-    snakeFood = new SnakeSegment( RandomMatrix<3, 1, float>(-EnvSphereSize * 0.5f, EnvSphereSize * 0.5f), 5, Color3f(1, 0, 0) );
+    this->Context = &Context;
+
+    // Create game objects on first use. Their state is set by Reset().
+    if (snake == NULL)
+    {
+        // Building the snake is not a steady-state tick
+        ALLOCATIONS_ALLOWED();
 
-    // Create camera
-    camera = new Camera( snake->GetPosition(), snake->GetHeading(), 80, 1, 200 );
+        snake = new Snake( Vector3f(0, 0, 0), Vector3f(1, 0, 0), 0.01f, 40, 1.0f );
+        snakeFood = Context.SegmentPool->New( Vector3f(0, 0, 0), 5, Color3f(1, 0, 0) );
+        camera = new Camera( snake->GetPosition(), snake->GetHeading(), 80, 1, 200 );
+    }
 
-    // Set the global current camera
-    Singleton<Camera *>::Instance() = camera;
+    // Hosts without settings get the defaults
+    ApplySettings( Context.Settings != NULL ? *Context.Settings : SettingFile() );
 
-    // Set line width for environment sphere render
-    glLineWidth( 5 );
+    Reset( Context.Random.Next() );
+
+    // Make the camera the context's current camera
+    Context.CurrentCamera = camera;
 
     Initialized = true;
-    Finished = false;
-    Paused = false;
 }
 
 void Snake3DGameWorld::DeInit()
 {
     if (Initialized)
     {
-        delete snake;
-        delete snakeFood;
-        delete camera;
+        if (Context->CurrentCamera == camera)
+            Context->CurrentCamera = NULL;
 
         Initialized = false;
     }
 }
 
+void Snake3DGameWorld::Reset( unsigned long Seed )
+{
+    PROFILE_SCOPE( "Snake3DGameWorld::Reset" );
+
+    Random.Seed( Seed );
+
+    snake->Reset( Vector3f(0, 0, 0), Vector3f(1, 0, 0), SnakeStartSegments );
+    snakeFood->SetPosition( RandomMatrix<3, 1, float>(Random, -EnvSphereSize * 0.5f, EnvSphereSize * 0.5f) );
+    *camera = Camera( snake->GetPosition(), snake->GetHeading(), 80, 1, 200 );
+
+    Finished = false;
+    Paused = false;
+}
+
 void Snake3DGameWorld::Update( float ElapsedTime )
 {
     // Process user input
-    ProcessKeys( Singleton<GLUTApp>::Instance().GetPressedKeys() );
-    ProcessMouseMotion( Singleton<GLUTApp>::Instance().GetMouseMotion() );
+    ProcessKeys( Context->Input );
+    ProcessMouseMotion( Context->Input.MouseMotion );
 
+    // Run every move that is due, in fixed steps, so the snake's speed and what it runs into
+    // don't depend on the frame rate. After a long stall the rest is dropped to catch up.
     snake->Update( ElapsedTime );
+    for (int Moves = 0; !Finished && snake->Move(); )
+    {
+        CheckCollisions();
+
+        if (++Moves == MaxMovesPerUpdate)
+        {
+            snake->DropPendingMoves();
+            break;
+        }
+    }
 
     // Move camera with snake
     camera->SetPosition( snake->GetPosition() - camera->GetLook() * 50 + Vector3f(0, 5, 0) );
+}
+
+void Snake3DGameWorld::CheckCollisions()
+{
+    // The head is swept along its last move, so however long the move nothing is passed through
+    const Vector3f &MoveStart = snake->GetLastMoveStart();
+    Vector3f MoveEnd = snake->GetPosition();
+    float TimeOfImpact;
 
     // Check for snake-environment sphere collision
-    if (snake->GetPosition().GetMagnitudeSqr() > TMath::Sqr(EnvSphereSize))
+    if (SweepSphereOutOfSphere( MoveStart, MoveEnd, 0, Vector3f(0.0f), EnvSphereSize, TimeOfImpact ))
+    {
         GameOver();
+        return;
+    }
 
     // Check for snake head-snake body collision
-    if (snake->IsSelfColliding())
+    if (snake->IsSelfColliding( TimeOfImpact ))
+    {
         GameOver();
+        return;
+    }
 
     // Check for snake-food collision
-    if ((snake->GetPosition() - snakeFood->GetPosition()).GetMagnitudeSqr() <= TMath::Sqr(snake->GetSegmentSize() + snakeFood->GetSize()))
+    if (SweepSphereSphere( MoveStart, MoveEnd, snake->GetSegmentSize(), snakeFood->GetPosition(), snakeFood->GetSize(), TimeOfImpact ))
     {
         // Add a segment to the snake
 		snake->IncreaseLength();
 
         // Reposition food
-		snakeFood->SetPosition( RandomMatrix<3, 1, float>(-EnvSphereSize * 0.5f, EnvSphereSize * 0.5f) );
+		snakeFood->SetPosition( RandomMatrix<3, 1, float>(Random, -EnvSphereSize * 0.5f, EnvSphereSize * 0.5f) );
     }
-    
-    // Set view matrix
-    Singleton<Camera *>::Instance()->ApplyGLViewMatrix();
 }
 
 void Snake3DGameWorld::Render() const
 {
+    // All GL state is set here so Update() can run without a GL context
+    camera->ApplyGLViewMatrix();
+
+    // Set line width for environment sphere render
+    glLineWidth( 5 );
+
     // Render the environment sphere. Depth buffer is disabled since the sphere should always be in the background.
     glDepthMask( false );
     glDisable( GL_DEPTH_TEST );
 
     glColor3f( 0, 0, 0 );
-    glutWireSphere( EnvSphereSize, 20, 20 );
+    glutWireSphere( EnvSphereSize, EnvSphereSlices, EnvSphereStacks );
 
     glDepthMask( true );
     glEnable( GL_DEPTH_TEST );
 
     snake->Render();
-    snakeFood->Render();
+    snakeFood->Render( SegmentSlices, SegmentStacks );
+
+    // Environment sphere and food
+    PROFILE_COUNT( "DrawCalls", 2 );
 }
 
 bool Snake3DGameWorld::IsFinished()
@@ -130,18 +197,57 @@ bool Snake3DGameWorld::IsFinished()
     return Finished;
 }
 
-void Snake3DGameWorld::ProcessMouseMotion( queue<Vector2f> &MotionQueue )
+void Snake3DGameWorld::ApplySettings( const SettingFile &Settings )
+{
+    // Settings are reloaded live, so every value is kept in a usable range
+    EnvSphereSize = Settings.GetValueAs<float>( "EnvSphereSize", 60 );
+    if (EnvSphereSize < 1)
+        EnvSphereSize = 1;
+
+    // Spheres need at least 3 slices and stacks to have any volume
+    EnvSphereSlices = Settings.GetValueAs<int>( "EnvSphereSlices", 20 );
+    EnvSphereStacks = Settings.GetValueAs<int>( "EnvSphereStacks", 20 );
+    SegmentSlices = Settings.GetValueAs<int>( "SegmentSlices", 15 );
+    SegmentStacks = Settings.GetValueAs<int>( "SegmentStacks", 5 );
+    EnvSphereSlices = EnvSphereSlices < 3 ? 3 : EnvSphereSlices;
+    EnvSphereStacks = EnvSphereStacks < 3 ? 3 : EnvSphereStacks;
+    SegmentSlices = SegmentSlices < 3 ? 3 : SegmentSlices;
+    SegmentStacks = SegmentStacks < 3 ? 3 : SegmentStacks;
+
+    // Self collision skips the segments right behind the head, so there must be more than those
+    SnakeStartSegments = Settings.GetValueAs<int>( "SnakeStartSegments", 40 );
+    if (SnakeStartSegments < 5)
+        SnakeStartSegments = 5;
+    if (SnakeStartSegments > static_cast<int>(Snake::MaxSegments))
+        SnakeStartSegments = static_cast<int>(Snake::MaxSegments);
+
+    // Segments added per food, capped so a typo can't ask for millions
+    int GrowthSegments = Settings.GetValueAs<int>( "SnakeGrowthSegments", 20 );
+    if (GrowthSegments < 0)
+        GrowthSegments = 0;
+    if (GrowthSegments > 10000)
+        GrowthSegments = 10000;
+
+    // Moves are run in fixed steps of the interval, keep it away from zero
+    float MoveInterval = Settings.GetValueAs<float>( "SnakeMoveInterval", 0.01f );
+    if (MoveInterval < 0.001f)
+        MoveInterval = 0.001f;
+    MaxMovesPerUpdate = Settings.GetValueAs<int>( "SnakeMaxMovesPerUpdate", 25 );
+    if (MaxMovesPerUpdate < 1)
+        MaxMovesPerUpdate = 1;
+
+    snake->SetMoveInterval( MoveInterval );
+    snake->SetGrowthSegments( GrowthSegments );
+    snake->SetTessellation( SegmentSlices, SegmentStacks );
+}
+
+void Snake3DGameWorld::ProcessMouseMotion( const Vector2f &Motion )
 {
-    if (MotionQueue.size() == 0)
+    if (Motion.x() == 0 && Motion.y() == 0)
         return;
 
-    // Sum mouse movements into a single rotation
-    Vector3f RotationSum(0);
-    for (const Vector2f &Move = MotionQueue.front(); !MotionQueue.empty(); MotionQueue.pop())
-    {
-        RotationSum.x() += Move.y();
-        RotationSum.y() += Move.x();
-    }
+    // Mouse movements are already summed, turn them into a single rotation
+    Vector3f RotationSum( Motion.y(), Motion.x(), 0 );
     RotationSum *= 2*TMath::PI;
 
     // Rotate snake & camera
@@ -149,11 +255,11 @@ void Snake3DGameWorld::ProcessMouseMotion( queue<Vector2f> &MotionQueue )
     camera->Rotate( RotationSum );
 }
 
-void Snake3DGameWorld::ProcessKeys( set<unsigned char> &PressedSet )
+void Snake3DGameWorld::ProcessKeys( const InputState &Input )
 {
     // Change to paused state on P key press
-	if (PressedSet.count( 'p' ) > 0)
-        Singleton<GLUTApp>::Instance().PushState( "Snake3DPaused" );
+	if (Input.IsKeyPressed( 'p' ))
+        Context->App.PushState( Snake3DPaused::ID );
 }
 
 void Snake3DGameWorld::GameOver()
@@ -161,7 +267,7 @@ void Snake3DGameWorld::GameOver()
     Finished = true;
 
     // Change to game over state
-	Singleton<GLUTApp>::Instance().PushState( "Snake3DGameOver" );
+	Context->App.PushState( Snake3DGameOver::ID );
 }
 
 
@@ -170,23 +276,30 @@ void Snake3DGameWorld::GameOver()
 // ------------------------------------------------------------------------------------
 
 // Set type ID for IGameState factory
-FactoryRegistrar<IGameState, Snake3DPaused, std::string> Snake3DPaused::Registrar( "Snake3DPaused" );
+FactoryRegistrar<IGameState, Snake3DPaused, HashedID> Snake3DPaused::Registrar( Snake3DPaused::ID );
 
 Snake3DPaused::Snake3DPaused()
 {
 	Initialized = false;
+
+    // Text is kept across Init()/DeInit() so pausing does not allocate
+	PauseText = new RenderTextData( "Game Paused", Vector2f(0, 0), Color3f(1, 0, 0), GLUT_BITMAP_HELVETICA_18 );
 }
 
 Snake3DPaused::~Snake3DPaused()
 {
 	DeInit();
+
+	delete PauseText;
 }
 
-void Snake3DPaused::Init()
+void Snake3DPaused::Init( EngineContext &Context )
 {
-	int WindowWidth = Singleton<GLUTApp>::Instance().GetWindowWidth(),
-		WindowHeight = Singleton<GLUTApp>::Instance().GetWindowHeight();
-	PauseText = new RenderTextData( "Game Paused", Vector2f(WindowWidth*0.5f - 50, WindowHeight*0.5f), Color3f(1, 0, 0), GLUT_BITMAP_HELVETICA_18 );
+    this->Context = &Context;
+
+	int WindowWidth = Context.App.GetWindowWidth(),
+		WindowHeight = Context.App.GetWindowHeight();
+	PauseText->Position = Vector2f(WindowWidth*0.5f - 50, WindowHeight*0.5f);
 
     Initialized = true;
     Finished = false;
@@ -195,27 +308,20 @@ void Snake3DPaused::Init()
 void Snake3DPaused::DeInit()
 {
 	if (Initialized)
-	{
-		delete PauseText;
-
         Initialized = false;
-	}
 }
 
 void Snake3DPaused::Update( float ElapsedTime )
 {
-	// Get reference to pressed key set
-	set<unsigned char> &PressedSet = Singleton<GLUTApp>::Instance().GetPressedKeys();
-
     // Unpause on U key press
-	if (PressedSet.count( 'u' ) > 0)
+	if (Context->Input.IsKeyPressed( 'u' ))
 		Finished = true;
 }
 
 void Snake3DPaused::Render() const
 {
 	// Render pause text
-	Singleton<GLUTApp>::Instance().RenderText( PauseText );
+	Context->App.RenderText( PauseText );
 }
 
 bool Snake3DPaused::IsFinished()
@@ -229,25 +335,31 @@ bool Snake3DPaused::IsFinished()
 // ------------------------------------------------------------------------------------
 
 // Set type ID for IGameState factory
-FactoryRegistrar<IGameState, Snake3DGameOver, std::string> Snake3DGameOver::Registrar( "Snake3DGameOver" );
+FactoryRegistrar<IGameState, Snake3DGameOver, HashedID> Snake3DGameOver::Registrar( Snake3DGameOver::ID );
 
 Snake3DGameOver::Snake3DGameOver()
 {
 	Initialized = false;
+
+    // Text is kept across Init()/DeInit() so ending a game does not allocate
+	GameOverText = new RenderTextData( "Game Over! Press space to play again. Press escape to exit.",
+                                       Vector2f(0, 0), Color3f(1, 0, 0), GLUT_BITMAP_HELVETICA_18 );
 }
 
 Snake3DGameOver::~Snake3DGameOver()
 {
 	DeInit();
+
+	delete GameOverText;
 }
 
-void Snake3DGameOver::Init()
+void Snake3DGameOver::Init( EngineContext &Context )
 {
-	int WindowWidth = Singleton<GLUTApp>::Instance().GetWindowWidth(),
-		WindowHeight = Singleton<GLUTApp>::Instance().GetWindowHeight();
-	GameOverText = new RenderTextData( "Game Over! Press space to play again. Press escape to exit.",
-                                       Vector2f(WindowWidth*0.5f - 250, WindowHeight*0.5f), Color3f(1, 0, 0),
-                                       GLUT_BITMAP_HELVETICA_18 );
+    this->Context = &Context;
+
+	int WindowWidth = Context.App.GetWindowWidth(),
+		WindowHeight = Context.App.GetWindowHeight();
+	GameOverText->Position = Vector2f(WindowWidth*0.5f - 250, WindowHeight*0.5f);
 
     Initialized = true;
     Finished = false;
@@ -256,30 +368,23 @@ void Snake3DGameOver::Init()
 void Snake3DGameOver::DeInit()
 {
 	if (Initialized)
-	{
-		delete GameOverText;
-
         Initialized = false;
-	}
 }
 
 void Snake3DGameOver::Update( float ElapsedTime )
 {
-	// Get reference to pressed key set
-	set<unsigned char> &PressedSet = Singleton<GLUTApp>::Instance().GetPressedKeys();
-
     // Restart game on space key press
-	if (PressedSet.count( ' ' ) > 0)
+	if (Context->Input.IsKeyPressed( ' ' ))
 	{
 		Finished = true;
-		Singleton<GLUTApp>::Instance().PushState( "Snake3DGameWorld" );
+		Context->App.PushState( Snake3DGameWorld::ID );
 	}
 }
 
 void Snake3DGameOver::Render() const
 {
 	// Render game over text
-	Singleton<GLUTApp>::Instance().RenderText( GameOverText );
+	Context->App.RenderText( GameOverText );
 }
 
 bool Snake3DGameOver::IsFinished()
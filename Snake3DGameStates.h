@@ -7,13 +7,11 @@
 // ----------------------------------Included headers----------------------------------
 // ------------------------------------------------------------------------------------
 
-// STL
-#include <queue>
-#include <set>
-
 // Utilities
 #include "Utilities\Factory.h"
+#include "Utilities\HashedID.h"
 #include "Utilities\Matrix.h"
+#include "Utilities\MersenneTwister.h"
 #include "Utilities\Timer.h"
 
 #include "IGameState.h"
@@ -23,41 +21,64 @@
 // ---------------------------------------Classes--------------------------------------
 // ------------------------------------------------------------------------------------
 
+struct EngineContext;
+struct InputState;
 class Snake;
 class SnakeSegment;
 class Camera;
 class Snake3DGameWorld : public IGameState
 {
 public:
+    // IGameState factory ID
+    static constexpr HashedID ID = HashedID( "Snake3DGameWorld" );
+
     Snake3DGameWorld();
     ~Snake3DGameWorld();
 
-    void Init();
+    void Init( EngineContext &Context );
     void DeInit();
 
+    // Start a new game in place. Game objects are reused, so this doesn't allocate unless the
+    // snake has to be longer than it ever was. Init() calls it with a seed drawn from the context.
+    void Reset( unsigned long Seed );
+
     void Update( float ElapsedTime );
     void Render() const;
 
     bool IsFinished();
 
+    // Gameplay and tessellation settings, all optional. SnakeStartSegments applies from the
+    // next game on, everything else immediately.
+    void ApplySettings( const SettingFile &Settings );
+
 private:
     // IGameState factory registrar
-    static FactoryRegistrar<IGameState, Snake3DGameWorld, std::string> Registrar;
+    static FactoryRegistrar<IGameState, Snake3DGameWorld, HashedID> Registrar;
 
+    EngineContext *Context;
+    // Generator for this game only, so a game replays exactly from its seed
+    MersenneTwister Random;
     Snake *snake;
     SnakeSegment *snakeFood;
 	Camera *camera;
     float EnvSphereSize;
+    int EnvSphereSlices, EnvSphereStacks;
+    int SegmentSlices, SegmentStacks;
+    int SnakeStartSegments;
+    // Moves run by one Update(), time owed beyond them is dropped
+    int MaxMovesPerUpdate;
 
     bool Initialized, Paused, Finished;
     PerformanceTimer PauseTimer;
 
 
     // User input processing
-    void ProcessMouseMotion( std::queue<Vector2f> &MotionQueue );
-    void ProcessKeys( std::set<unsigned char> &PressedSet );
+    void ProcessMouseMotion( const Vector2f &Motion );
+    void ProcessKeys( const InputState &Input );
 
     // Misc utility methods
+    // Collision checks after each move of the snake
+    void CheckCollisions();
     void GameOver();
 };
 
@@ -65,10 +86,13 @@ struct RenderTextData;
 class Snake3DPaused : public IGameState
 {
 public:
+    // IGameState factory ID
+    static constexpr HashedID ID = HashedID( "Snake3DPaused" );
+
     Snake3DPaused();
     ~Snake3DPaused();
 
-    void Init();
+    void Init( EngineContext &Context );
     void DeInit();
 
     void Update( float ElapsedTime );
@@ -78,8 +102,9 @@ public:
 
 private:
     // IGameState factory registrar
-    static FactoryRegistrar<IGameState, Snake3DPaused, std::string> Registrar;
+    static FactoryRegistrar<IGameState, Snake3DPaused, HashedID> Registrar;
 
+    EngineContext *Context;
 	RenderTextData *PauseText;
     bool Initialized, Finished;
 };
@@ -87,10 +112,13 @@ private:
 class Snake3DGameOver : public IGameState
 {
 public:
+    // IGameState factory ID
+    static constexpr HashedID ID = HashedID( "Snake3DGameOver" );
+
     Snake3DGameOver();
     ~Snake3DGameOver();
 
-    void Init();
+    void Init( EngineContext &Context );
     void DeInit();
 
     void Update( float ElapsedTime );
@@ -100,8 +128,9 @@ public:
 
 private:
     // IGameState factory registrar
-    static FactoryRegistrar<IGameState, Snake3DGameOver, std::string> Registrar;
+    static FactoryRegistrar<IGameState, Snake3DGameOver, HashedID> Registrar;
 
+    EngineContext *Context;
 	RenderTextData *GameOverText;
     bool Initialized, Finished;
 };
@@ -3,8 +3,9 @@
 // ------------------------------------------------------------------------------------
 #include "Snake3DObjects.h"
 
-// STL
-#include <list>
+// C++ standard library & STL
+#include <new>
+#include <algorithm>
 using namespace std;
 
 // Windows/OpenGL
@@ -15,12 +16,19 @@ using namespace std;
 // Utilities
 #include "Utilities\Matrix.h"
 #include "Utilities\Rand Utilities.h"
+#include "Utilities\Profiler.h"
+#include "Utilities\AllocationTracker.h"
+#include "Utilities\Exceptions.h"
 
 
 // ------------------------------------------------------------------------------------
 // --------------------------------SnakeSegment Members--------------------------------
 // ------------------------------------------------------------------------------------
 
+SnakeSegment::SnakeSegment()
+: Position(0.0f), Size(0), Color(0.0f)
+{
+}
 SnakeSegment::SnakeSegment( const Vector3f &Position, float Size, const Color3f &Color )
 : Position(Position), Size(Size), Color(Color)
 {
@@ -35,7 +43,7 @@ bool SnakeSegment::Intersect( const SnakeSegment *s1, const SnakeSegment *s2 )
     return (s1->GetPosition() - s2->GetPosition()).GetMagnitudeSqr() <= TMath::Sqr(s1->GetSize() + s2->GetSize());
 }
 
-void SnakeSegment::Render() const
+void SnakeSegment::Render( int Slices, int Stacks ) const
 {
     glColor3fv( (const float *)&Color );
 
@@ -43,72 +51,216 @@ void SnakeSegment::Render() const
 
     glTranslatef( Position.x(), Position.y(), Position.z() );
 
-    glutSolidSphere( Size, 15, 5 );
+    glutSolidSphere( Size, Slices, Stacks );
 
     glPopMatrix();
 }
 
 
+// ------------------------------------------------------------------------------------
+// ----------------------------------Static functions----------------------------------
+// ------------------------------------------------------------------------------------
+
+// Alignment of the snake body streams, a cache line
+static const size_t StreamAlignment = 64;
+
+// Frustum planes of the current OpenGL projection and modelview matrices
+static void GetGLFrustumPlanes( Vector4f Planes[6] )
+{
+    float Projection[16], ModelView[16], Clip[16];
+    glGetFloatv( GL_PROJECTION_MATRIX, Projection );
+    glGetFloatv( GL_MODELVIEW_MATRIX, ModelView );
+
+    // Clip = Projection * ModelView, both column-major
+    for (int Column = 0; Column < 4; Column++)
+        for (int Row = 0; Row < 4; Row++)
+        {
+            Clip[Column*4 + Row] = 0;
+            for (int k = 0; k < 4; k++)
+                Clip[Column*4 + Row] += Projection[k*4 + Row] * ModelView[Column*4 + k];
+        }
+
+    ExtractFrustumPlanes( Clip, Planes );
+}
+
+// Copy Count elements of a ring buffer starting at slot Head into Dest, head first
+template <typename T>
+static void CopyUnwrapped( const T *Source, T *Dest, unsigned int Head, unsigned int Count, unsigned int Capacity )
+{
+    if (Count == 0)
+        return;
+
+    unsigned int FirstRun = Count < Capacity - Head ? Count : Capacity - Head;
+    copy( Source + Head, Source + Head + FirstRun, Dest );
+    copy( Source, Source + Count - FirstRun, Dest + FirstRun );
+}
+
+
 // ------------------------------------------------------------------------------------
 // ------------------------------------Snake Members-----------------------------------
 // ------------------------------------------------------------------------------------
 
 Snake::Snake( const Vector3f &HeadPosition, const Vector3f &Heading, float MoveInterval, int NumSegments, float SegmentSize )
-: Heading(Heading), MoveInterval(MoveInterval), SegmentSize(SegmentSize), Up(0, 1, 0)
+: Heading(Heading), MoveInterval(MoveInterval), SegmentSize(SegmentSize), GrowthSegments(20), Slices(15), Stacks(5),
+  Up(0, 1, 0), X(NULL), Y(NULL), Z(NULL), StreamMemory(NULL), Capacity(0), HeadIndex(0), NumSegments(0), PendingGrowth(0)
 {
+    ALLOCATION_TAG( "Snake" );
+
+    BuildPattern();
+    Reset( HeadPosition, Heading, NumSegments );
+}
+
+Snake::~Snake()
+{
+    ::operator delete( StreamMemory, align_val_t(StreamAlignment) );
+}
+
+void Snake::Reset( const Vector3f &HeadPosition, const Vector3f &Heading, int NumSegments )
+{
+    if (NumSegments < 1 || static_cast<unsigned int>(NumSegments) > MaxSegments)
+        throw ArgumentException( "NumSegments", "A snake needs between 1 and Snake::MaxSegments segments." );
+
     ElapsedSinceMove = 0;
+    PendingGrowth = 0;
+    LastMoveStart = HeadPosition;
 
     // Assure heading is a unit vector and calculate right vector
+    this->Heading = Heading;
     this->Heading.Normalize();
-	VectorCross( Up, Heading, Right );
+    Up = Vector3f(0, 1, 0);
+	VectorCross( Up, this->Heading, Right );
 
-    // Create segments
+    // Capacity left by a longer snake is kept for the next one
+    Reserve( NumSegments );
+    HeadIndex = 0;
+    this->NumSegments = NumSegments;
+
+    // Lay the body out behind the head
     for (int i = 0; i < NumSegments; i++)
-        Segments.push_back( new SnakeSegment( -Heading * i, SegmentSize ) );
+    {
+        Vector3f Position = HeadPosition - this->Heading * i;
+        X[i] = Position.x();
+        Y[i] = Position.y();
+        Z[i] = Position.z();
+    }
+
+    RebuildSpatialIndices();
 }
 
-Snake::~Snake()
+void Snake::Reserve( unsigned int Count )
+{
+    if (Count <= Capacity)
+        return;
+
+    // Doubling keeps the capacity a power of two and amortizes the copy. Capacities are
+    // multiples of 64 so every stream starts aligned.
+    unsigned int NewCapacity = Capacity > 0 ? Capacity : 64;
+    while (NewCapacity < Count)
+        NewCapacity *= 2;
+
+    void *NewMemory = ::operator new( NewCapacity * StreamBytesPerSegment, align_val_t(StreamAlignment) );
+    float *NewX = static_cast<float *>(NewMemory),
+          *NewY = NewX + NewCapacity,
+          *NewZ = NewY + NewCapacity;
+
+    // Unwrap the body into the new streams, head first
+    CopyUnwrapped( X, NewX, HeadIndex, NumSegments, Capacity );
+    CopyUnwrapped( Y, NewY, HeadIndex, NumSegments, Capacity );
+    CopyUnwrapped( Z, NewZ, HeadIndex, NumSegments, Capacity );
+
+    ::operator delete( StreamMemory, align_val_t(StreamAlignment) );
+
+    StreamMemory = NewMemory;
+    X = NewX;
+    Y = NewY;
+    Z = NewZ;
+    Capacity = NewCapacity;
+    HeadIndex = 0;
+
+    RebuildSpatialIndices();
+}
+
+void Snake::RebuildSpatialIndices()
 {
-    for (list<SnakeSegment *>::iterator it = Segments.begin(); it != Segments.end(); ++it)
-        delete *it;
+    // Heading is a unit vector, so a move is one unit long
+    Grid.Reset( Capacity, 2 * GetMaxRadius() + 1 );
+
+    for (unsigned int i = 0; i < NumSegments; i++)
+        Grid.Insert( i, GetSegmentPosition( i ) );
+
+    Hierarchy.Reset( Capacity, GetMaxRadius() );
+    Hierarchy.Build( X, Y, Z, HeadIndex, NumSegments );
 }
 
 void Snake::Update( float ElapsedTime )
 {
+    PROFILE_SCOPE( "Snake::Update" );
+
     ElapsedSinceMove += ElapsedTime;
 
-    // If enough time has passed to make a move
-    if (ElapsedSinceMove >= MoveInterval)
+    PROFILE_SET_COUNT( "SnakeSegments", NumSegments );
+    PROFILE_SET_COUNT( "SnakeBufferBytes", GetReservedBytes() );
+}
+
+bool Snake::Move()
+{
+    if (ElapsedSinceMove < MoveInterval)
+        return false;
+
+    // Leftover time carries over, so the move rate doesn't depend on the update rate
+    ElapsedSinceMove -= MoveInterval;
+
+    // Step the head back into the free slot before it, which is only the old tail's slot when
+    // the buffer is full. Unless the snake is growing the tail drops out of the body, its slot
+    // left as free space for later moves.
+    LastMoveStart = GetPosition();
+    Vector3f NewHeadPosition = LastMoveStart + Heading;
+    unsigned int TailSlot = GetSlot( NumSegments - 1 );
+    bool Growing = PendingGrowth > 0;
+    if (Growing)
     {
-        // Remove the end segment
-        SnakeSegment *tail = Segments.back();
-        Segments.pop_back();
+        PendingGrowth--;
+        NumSegments++;
+    }
+    else
+        Grid.Remove( TailSlot );
 
-        // Reset the tail segment to be the new head
-        tail->SetPosition( Segments.front()->GetPosition() + Heading );
+    HeadIndex = (HeadIndex - 1) & (Capacity - 1);
+    X[HeadIndex] = NewHeadPosition.x();
+    Y[HeadIndex] = NewHeadPosition.y();
+    Z[HeadIndex] = NewHeadPosition.z();
+    Grid.Insert( HeadIndex, NewHeadPosition );
 
-        // Add new head
-        Segments.push_front( tail );
+    if (!Growing)
+        Hierarchy.Refit( TailSlot, HeadIndex, NumSegments );
+    Hierarchy.Refit( HeadIndex, HeadIndex, NumSegments );
 
-        ElapsedSinceMove = 0;
-    }
+    return true;
+}
 
+void Snake::DropPendingMoves()
+{
+    if (ElapsedSinceMove >= MoveInterval)
+        ElapsedSinceMove = TMath::Mod( ElapsedSinceMove, MoveInterval );
+}
+
+void Snake::BuildPattern()
+{
     // Colors to interpolate between
     Color3f StartColor(0.463f, 0.282f, 0), // Brown
             EndColor(0, 1, 0); // Green
 
     // Sizes to interpolate between
-    float StartSize = SegmentSize * 1.25f,
-          EndSize = StartSize * 2;
+    float EndSize = GetMaxRadius(),
+          StartSize = EndSize * 0.5f;
 
-    // Interpolate segment color and size based on position within the snake
-    int i = 0;
-    for (list<SnakeSegment *>::iterator it = Segments.begin(); it != Segments.end(); ++it, i++)
+    // Interpolate segment color and size based on position within the pattern
+    for (unsigned int i = 0; i < PatternLength; i++)
     {
         float x = GetInterpolationCoeff( i );
 
-        (*it)->SetColor( TMath::CosineInterpolate( x, StartColor, EndColor ) );
-        (*it)->SetSize( TMath::CosineInterpolate( x, StartSize, EndSize ) );
+        PatternColors[i] = TMath::CosineInterpolate( x, StartColor, EndColor );
+        PatternRadii[i] = TMath::CosineInterpolate( x, StartSize, EndSize );
     }
 }
 
@@ -128,9 +280,43 @@ float Snake::GetInterpolationCoeff( int i )
 
 void Snake::Render() const
 {
-    // Render segments
-    for (list<SnakeSegment *>::const_iterator it = Segments.begin(); it != Segments.end(); ++it)
-        (*it)->Render();
+    PROFILE_SCOPE( "Snake::Render" );
+
+    // Only segments in view are drawn
+    Vector4f Planes[6];
+    GetGLFrustumPlanes( Planes );
+
+    unsigned int Drawn = 0;
+    auto RenderSegment = [&]( unsigned int i ) -> bool
+    {
+        unsigned int Slot = GetSlot( i ), Phase = i % PatternLength;
+
+        glColor3fv( (const float *)&PatternColors[Phase] );
+
+        glPushMatrix();
+        glTranslatef( X[Slot], Y[Slot], Z[Slot] );
+        glutSolidSphere( PatternRadii[Phase], Slices, Stacks );
+        glPopMatrix();
+
+        Drawn++;
+        return false;
+    };
+    QueryFrustum( Planes, RenderSegment );
+
+    PROFILE_UNITS( Drawn );
+    PROFILE_COUNT( "DrawCalls", Drawn );
+}
+
+SegmentFootprint Snake::GetSegmentFootprint() const
+{
+    SegmentFootprint Footprint;
+
+    // Segments are spread over the streams, there are no per-segment nodes or heap blocks
+    size_t Reserved = GetReservedBytes(), Used = NumSegments * BytesPerSegment;
+    Footprint.SegmentBytes = BytesPerSegment;
+    Footprint.SlackBytes = NumSegments > 0 && Reserved > Used ? (Reserved - Used) / NumSegments : 0;
+
+    return Footprint;
 }
 
 void Snake::RotateHeading( const Vector3f &Rotation )
@@ -150,26 +336,75 @@ void Snake::RotateHeading( const Vector3f &Rotation )
 
 void Snake::IncreaseLength()
 {
-    // Add new segments to the end of the snake
-	for (int i = 0; i < 20; i++)
-		Segments.push_back( new SnakeSegment( Segments.back()->GetPosition(), 0 ) );
+    // Growth may reallocate the streams, only the ticks in between have to be allocation free.
+    // Reserving now keeps Move() from ever allocating.
+    ALLOCATION_TAG( "Snake" );
+    ALLOCATIONS_ALLOWED();
+
+    // The snake grows by keeping its tail for the next moves, up to MaxSegments
+    unsigned int Room = MaxSegments - NumSegments - PendingGrowth;
+    PendingGrowth += GrowthSegments < Room ? GrowthSegments : Room;
+    Reserve( NumSegments + PendingGrowth );
 }
 
-bool Snake::IsSelfColliding() const
+bool Snake::IsSelfColliding( float &TimeOfImpact ) const
 {
-    SnakeSegment * const Head = Segments.front();
-    
-    // Prevent head collision with self or the next few segments
-    list<SnakeSegment *>::const_iterator it = Segments.begin();
-    for (int i = 0; i < 4; i++)
-        ++it;
+    PROFILE_SCOPE( "Snake::IsSelfColliding" );
 
-    // Iterate through segments, checking for collisions with head
-    for (; it != Segments.end(); ++it)
+    Vector3f Head = GetPosition();
+    float HeadRadius = PatternRadii[0];
+    unsigned long long Tested = 0;
+    bool Colliding = false;
+
+    // Sweep the head along its last move, so a long move can't pass through the body. Only
+    // segments in the cells around the head can have been touched, keep the earliest hit.
+    auto SweepHead = [&]( unsigned int Slot ) -> bool
     {
-        if (SnakeSegment::Intersect( Head, *it ))
-            return true;
-    }
+        // Prevent head collision with self or the next few segments
+        unsigned int i = GetSegmentIndex( Slot );
+        if (i < 4)
+            return false;
+
+        Tested++;
+        float Time;
+        if (SweepSphereSphere( LastMoveStart, Head, HeadRadius, Vector3f( X[Slot], Y[Slot], Z[Slot] ), PatternRadii[i % PatternLength], Time ) &&
+            (!Colliding || Time < TimeOfImpact))
+        {
+            TimeOfImpact = Time;
+            Colliding = true;
+        }
+
+        // Nothing hits earlier than the start of the move
+        return Colliding && TimeOfImpact == 0;
+    };
+    Grid.Query( Head, SweepHead );
+
+    PROFILE_UNITS( Tested );
+    PROFILE_COUNT( "CollisionTests", Tested );
+    return Colliding;
+}
+
+bool Snake::RayCast( const Vector3f &Origin, const Vector3f &Direction, float MaxDistance, unsigned int &Segment, float &Distance ) const
+{
+    PROFILE_SCOPE( "Snake::RayCast" );
 
-    return false;
+    // Keep the nearest hit, and stop looking past it
+    bool Hit = false;
+    auto NearestHit = [&]( unsigned int Slot ) -> bool
+    {
+        unsigned int i = GetSegmentIndex( Slot );
+        float HitDistance;
+        if (RaySphere( Origin, Direction, Vector3f( X[Slot], Y[Slot], Z[Slot] ), PatternRadii[i % PatternLength], HitDistance ) &&
+            HitDistance <= MaxDistance)
+        {
+            Segment = i;
+            Distance = MaxDistance = HitDistance;
+            Hit = true;
+        }
+
+        return false;
+    };
+    Hierarchy.QueryRay( Origin, Direction, MaxDistance, NearestHit );
+
+    return Hit;
 }
\ No newline at end of file
@@ -7,8 +7,8 @@
 // ----------------------------------Included headers----------------------------------
 // ------------------------------------------------------------------------------------
 
-// STL
-#include <list>
+// C++ standard library
+#include <cstddef>
 
 // Windows/OpenGL
 #include <Windows.h>
@@ -16,6 +16,28 @@
 
 // Utilities
 #include "Utilities\Matrix.h"
+#include "Utilities\SpatialHash.h"
+#include "Utilities\BoundingHierarchy.h"
+#include "Utilities\Intersection.h"
+
+
+// ------------------------------------------------------------------------------------
+// --------------------------------------Structures------------------------------------
+// ------------------------------------------------------------------------------------
+
+// Memory cost of one snake segment
+struct SegmentFootprint
+{
+    // Bytes each buffer slot costs, Snake::BytesPerSegment: the three position floats plus the
+    // slot's share of the spatial hash and the bounding hierarchy
+    size_t SegmentBytes;
+
+    // Unused capacity of the streams, grid and hierarchy, averaged over the live segments.
+    // Capacity doubles as the snake grows, so this stays below SegmentBytes.
+    size_t SlackBytes;
+
+    inline size_t GetTotalBytes() const;
+};
 
 
 // ------------------------------------------------------------------------------------
@@ -26,6 +48,7 @@ class SnakeSegment
 {
 public:
     // Constructors
+    SnakeSegment();
     SnakeSegment( const Vector3f &Position, float Size, const Color3f &Color );
     SnakeSegment( const Vector3f &Position, float Size );
 
@@ -41,7 +64,8 @@ public:
 
     // Methods
     static bool Intersect( const SnakeSegment *s1, const SnakeSegment *s2 );
-    void Render() const;
+    // Render as a sphere with the given tessellation
+    void Render( int Slices, int Stacks ) const;
 
 private:
     Vector3f Position;
@@ -53,30 +77,130 @@ private:
 class Snake
 {
 public:
+    // Bytes each segment takes in the body's position streams
+    static const size_t StreamBytesPerSegment = 3 * sizeof(float);
+    // Bytes each segment takes in the streams, collision grid and hierarchy together
+    static const size_t BytesPerSegment = StreamBytesPerSegment + SpatialHash::BytesPerSlot + BoundingHierarchy::BytesPerSlot;
+    // Longest body, a power of two so the ring buffer's capacity can't overflow
+    static const unsigned int MaxSegments = 1u << 24;
+
     // Constructors
     Snake( const Vector3f &HeadPosition, const Vector3f &Heading, float MoveInterval, int NumSegments, float SegmentSize );
     ~Snake();
 
     // Accessors
-    inline const Vector3f &GetPosition() const;
+    inline Vector3f GetPosition() const;
+    // Head position before the last move, the head's own position before the first
+    inline const Vector3f &GetLastMoveStart() const;
     inline const Vector3f &GetHeading() const;
     inline float GetSegmentSize() const;
+    inline unsigned int GetNumSegments() const;
+    // Segments still to be added by the coming moves
+    inline unsigned int GetPendingGrowth() const;
+    // Capacity reserved by the streams, grid and hierarchy
+    inline size_t GetReservedBytes() const;
+
+    // Body segment i counting from the head, which is segment 0
+    inline Vector3f GetSegmentPosition( unsigned int i ) const;
+    inline float GetSegmentRadius( unsigned int i ) const;
+    inline const Color3f &GetSegmentColor( unsigned int i ) const;
+    inline SnakeSegment GetSegment( unsigned int i ) const;
+
+    // Modifiers
+    inline void SetMoveInterval( float moveInterval );
+    // Negative growth is taken as none
+    inline void SetGrowthSegments( int growthSegments );
+    inline void SetTessellation( int slices, int stacks );
+
+    // Memory cost of each segment of the body
+    SegmentFootprint GetSegmentFootprint() const;
 
     // Methods
+    // Add ElapsedTime to the time owed in moves. Moves are made one at a time by Move(), so
+    // the caller can check collisions after each.
     void Update( float ElapsedTime );
+    // Make the next move if one is due, returns false once the snake has caught up
+    bool Move();
+    // Forget the moves still due, keeping the time towards the next one
+    void DropPendingMoves();
     void Render() const;
+    // Put the snake back in its starting pose with NumSegments segments, keeping the buffer's capacity.
+    // Throws ArgumentException unless 1 <= NumSegments <= MaxSegments.
+    void Reset( const Vector3f &HeadPosition, const Vector3f &Heading, int NumSegments );
     void RotateHeading( const Vector3f &Rotation );
+    // Grow by GrowthSegments segments over the next moves
     void IncreaseLength();
-    bool IsSelfColliding() const;
+    // Whether the head ran into the body during the last move. TimeOfImpact is set to the
+    // fraction of the move at which it first touched.
+    bool IsSelfColliding( float &TimeOfImpact ) const;
+
+    // Queries against the body, reporting segments by index from the head
+    // Nearest segment hit by the ray from Origin along unit Direction within MaxDistance
+    bool RayCast( const Vector3f &Origin, const Vector3f &Direction, float MaxDistance, unsigned int &Segment, float &Distance ) const;
+    // Call Visit( i ) for each segment i touching the sphere, stop and return true as soon as Visit does
+    template <typename Visitor>
+    bool QuerySphere( const Vector3f &Center, float Radius, Visitor &Visit ) const;
+    // Call Visit( i ) for each segment i at least partly inside the frustum, see ExtractFrustumPlanes()
+    template <typename Visitor>
+    bool QueryFrustum( const Vector4f Planes[6], Visitor &Visit ) const;
 
 private:
-    Vector3f Heading, Up, Right;
+    Vector3f Heading, Up, Right, LastMoveStart;
+    // Seconds per move, must be positive
     float MoveInterval, SegmentSize;
-    std::list<SnakeSegment *> Segments;
+    // Segments IncreaseLength() adds over the following moves
+    unsigned int GrowthSegments;
+    // Sphere tessellation of each segment
+    int Slices, Stacks;
+    // Ring buffer holding the body positions head first, stored as one 64 byte aligned stream
+    // per coordinate. The capacity is a power of two, the head is in slot HeadIndex and
+    // segment i in slot (HeadIndex + i) modulo the capacity. Moving the snake steps HeadIndex
+    // back and writes the new head there, the old tail's slot simply leaves the body.
+    float *X, *Y, *Z;
+    void *StreamMemory;
+    unsigned int Capacity, HeadIndex, NumSegments;
+    // Moves left that keep the tail in place
+    unsigned int PendingGrowth;
     float ElapsedSinceMove;
 
+    // Segment colors and sizes repeat every PatternLength segments from the head, so they are
+    // looked up by segment index rather than stored per slot. A move shifts the pattern along
+    // the body with nothing to rewrite.
+    static const unsigned int PatternLength = 20;
+    Color3f PatternColors[PatternLength];
+    float PatternRadii[PatternLength];
+
+    // Body slots hashed by position for self collision. A segment only moves when it becomes
+    // the head, so a move is one removal and one insertion. Cells are twice the largest
+    // radius plus a move across, so anything the head touched during its last move is in the
+    // 27 cells around it.
+    SpatialHash Grid;
+
+    // Bounding boxes over runs of consecutive slots for ray, sphere and frustum queries. A
+    // move refits the leaves of the new head and the old tail, and the nodes above them.
+    BoundingHierarchy Hierarchy;
+
+
+    // Slot of segment i counting from the head
+    inline unsigned int GetSlot( unsigned int i ) const;
+    // Segment index of a slot in the body
+    inline unsigned int GetSegmentIndex( unsigned int Slot ) const;
+
+    // Grow the ring buffer to hold at least Count segments, Count being at most MaxSegments
+    void Reserve( unsigned int Count );
+    // Put the whole body into an emptied grid and hierarchy
+    void RebuildSpatialIndices();
+
+    // Largest radius in the pattern
+    inline float GetMaxRadius() const;
 
+    // Fill the color and size pattern
+    void BuildPattern();
 	float GetInterpolationCoeff( int i );
+
+    // Disable copying
+    Snake( const Snake & );
+    Snake &operator = ( const Snake & );
 };
 
 
@@ -84,6 +208,14 @@ private:
 // -----------------------------Inline function definitions----------------------------
 // ------------------------------------------------------------------------------------
 
+// ------------------------------SegmentFootprint members------------------------------
+
+size_t SegmentFootprint::GetTotalBytes() const
+{
+    return SegmentBytes + SlackBytes;
+}
+
+
 // --------------------------------SnakeSegment members--------------------------------
 
 const Vector3f &SnakeSegment::GetPosition() const
@@ -119,9 +251,14 @@ void SnakeSegment::SetColor( const Color3f &color )
 
 // ------------------------------------Snake members-----------------------------------
 
-const Vector3f &Snake::GetPosition() const
+Vector3f Snake::GetPosition() const
 {
-    return Segments.front()->GetPosition();
+    return Vector3f( X[HeadIndex], Y[HeadIndex], Z[HeadIndex] );
+}
+
+const Vector3f &Snake::GetLastMoveStart() const
+{
+    return LastMoveStart;
 }
 
 const Vector3f &Snake::GetHeading() const
@@ -134,6 +271,109 @@ float Snake::GetSegmentSize() const
     return SegmentSize;
 }
 
+unsigned int Snake::GetNumSegments() const
+{
+    return NumSegments;
+}
+
+unsigned int Snake::GetPendingGrowth() const
+{
+    return PendingGrowth;
+}
+
+size_t Snake::GetReservedBytes() const
+{
+    return Capacity * StreamBytesPerSegment + Grid.GetReservedBytes() + Hierarchy.GetReservedBytes();
+}
+
+Vector3f Snake::GetSegmentPosition( unsigned int i ) const
+{
+    unsigned int Slot = GetSlot( i );
+    return Vector3f( X[Slot], Y[Slot], Z[Slot] );
+}
+
+float Snake::GetSegmentRadius( unsigned int i ) const
+{
+    return PatternRadii[i % PatternLength];
+}
+
+const Color3f &Snake::GetSegmentColor( unsigned int i ) const
+{
+    return PatternColors[i % PatternLength];
+}
+
+SnakeSegment Snake::GetSegment( unsigned int i ) const
+{
+    return SnakeSegment( GetSegmentPosition( i ), GetSegmentRadius( i ), GetSegmentColor( i ) );
+}
+
+void Snake::SetMoveInterval( float moveInterval )
+{
+    MoveInterval = moveInterval;
+}
+
+void Snake::SetGrowthSegments( int growthSegments )
+{
+    GrowthSegments = growthSegments > 0 ? static_cast<unsigned int>(growthSegments) : 0;
+}
+
+void Snake::SetTessellation( int slices, int stacks )
+{
+    Slices = slices;
+    Stacks = stacks;
+}
+
+unsigned int Snake::GetSlot( unsigned int i ) const
+{
+    return (HeadIndex + i) & (Capacity - 1);
+}
+
+unsigned int Snake::GetSegmentIndex( unsigned int Slot ) const
+{
+    return (Slot - HeadIndex) & (Capacity - 1);
+}
+
+float Snake::GetMaxRadius() const
+{
+    return SegmentSize * 2.5f;
+}
+
+
+
+// ------------------------------------------------------------------------------------
+// ---------------------------Templatized member definitions---------------------------
+// ------------------------------------------------------------------------------------
+
+template <typename Visitor>
+bool Snake::QuerySphere( const Vector3f &Center, float Radius, Visitor &Visit ) const
+{
+    auto VisitTouching = [&]( unsigned int Slot ) -> bool
+    {
+        unsigned int i = GetSegmentIndex( Slot );
+        float DX = X[Slot] - Center.x(), DY = Y[Slot] - Center.y(), DZ = Z[Slot] - Center.z();
+        if (DX*DX + DY*DY + DZ*DZ > TMath::Sqr(PatternRadii[i % PatternLength] + Radius))
+            return false;
+
+        return Visit( i );
+    };
+
+    return Hierarchy.QuerySphere( Center, Radius, VisitTouching );
+}
+
+template <typename Visitor>
+bool Snake::QueryFrustum( const Vector4f Planes[6], Visitor &Visit ) const
+{
+    auto VisitInside = [&]( unsigned int Slot ) -> bool
+    {
+        unsigned int i = GetSegmentIndex( Slot );
+        if (!SphereInFrustum( Planes, Vector3f( X[Slot], Y[Slot], Z[Slot] ), PatternRadii[i % PatternLength] ))
+            return false;
+
+        return Visit( i );
+    };
+
+    return Hierarchy.QueryFrustum( Planes, VisitInside );
+}
 
 
 #endif
\ No newline at end of file
@@ -0,0 +1,182 @@
+// ------------------------------------------------------------------------------------
+// ----------------------------------Included headers----------------------------------
+// ------------------------------------------------------------------------------------
+#include "SnakeTrajectory.h"
+
+// C++ standard library & STL
+#include <vector>
+using namespace std;
+
+// Utilities
+#include "Utilities\Matrix.h"
+#include "Utilities\TMath.h"
+
+
+// ------------------------------------------------------------------------------------
+// ------------------------------SnakeTrajectory Members-------------------------------
+// ------------------------------------------------------------------------------------
+
+SnakeTrajectory::SnakeTrajectory()
+: OldestRun(0), NumRuns(0), Direction(0.0f), HeadStep(0), TailStep(0), HeadPosition(0.0f)
+{
+    Reset( Vector3f(0.0f), Vector3f(1, 0, 0), 1 );
+}
+
+void SnakeTrajectory::Reset( const Vector3f &HeadPosition, const Vector3f &Heading, unsigned int NumSegments )
+{
+    if (NumSegments < 1)
+        NumSegments = 1;
+
+    OldestRun = 0;
+    NumRuns = 0;
+
+    // One run from the tail up to the head
+    unsigned short Code = EncodeDirection( Heading );
+    Vector3f Step = DecodeDirection( Code );
+    TailStep = 0;
+    HeadStep = NumSegments - 1;
+    PushRun( HeadPosition - Step * static_cast<float>(HeadStep), Code );
+
+    this->HeadPosition = GetSegmentPosition( 0 );
+}
+
+void SnakeTrajectory::Move( const Vector3f &Heading, bool Grow )
+{
+    HeadStep++;
+
+    // Extend the newest run, or start one where the direction changes
+    unsigned short Code = EncodeDirection( Heading );
+    const Run &Newest = GetRun( NumRuns - 1 );
+    if (Code == Newest.Code)
+        HeadPosition = Newest.Start + Direction * static_cast<float>(HeadStep - Newest.FirstStep);
+    else
+    {
+        HeadPosition = HeadPosition + DecodeDirection( Code );
+        PushRun( HeadPosition, Code );
+    }
+
+    if (Grow)
+        return;
+
+    // Drop the oldest run once the tail has left it
+    TailStep++;
+    if (NumRuns > 1 && GetRun( 1 ).FirstStep == TailStep)
+    {
+        OldestRun = (OldestRun + 1) & (Runs.size() - 1);
+        NumRuns--;
+    }
+}
+
+Vector3f SnakeTrajectory::GetSegmentPosition( unsigned int i ) const
+{
+    unsigned int Offset = HeadStep - i - TailStep;
+    const Run &Found = GetRun( FindRun( Offset ) );
+
+    return Found.Start + DecodeDirection( Found.Code ) * static_cast<float>(TailStep + Offset - Found.FirstStep);
+}
+
+void SnakeTrajectory::GetSegmentPositions( unsigned int First, unsigned int Count, float *X, float *Y, float *Z ) const
+{
+    if (Count == 0)
+        return;
+
+    // Walk from segment First towards the tail, stepping back a run as each one runs out
+    unsigned int Offset = HeadStep - First - TailStep,
+                 r = FindRun( Offset );
+    const Run *Current = &GetRun( r );
+    Vector3f Step = DecodeDirection( Current->Code );
+
+    for (unsigned int i = 0; i < Count; i++, Offset--)
+    {
+        if (Offset < GetRunOffset( r ))
+        {
+            Current = &GetRun( --r );
+            Step = DecodeDirection( Current->Code );
+        }
+
+        Vector3f Position = Current->Start + Step * static_cast<float>(TailStep + Offset - Current->FirstStep);
+        X[i] = Position.x();
+        Y[i] = Position.y();
+        Z[i] = Position.z();
+    }
+}
+
+unsigned int SnakeTrajectory::FindRun( unsigned int Offset ) const
+{
+    // Last run starting at or before Offset
+    unsigned int Low = 0, High = NumRuns - 1;
+    while (Low < High)
+    {
+        unsigned int Middle = (Low + High + 1) / 2;
+        if (GetRunOffset( Middle ) <= Offset)
+            Low = Middle;
+        else
+            High = Middle - 1;
+    }
+
+    return Low;
+}
+
+void SnakeTrajectory::PushRun( const Vector3f &Start, unsigned short Code )
+{
+    // Double the ring when full, unwrapping it oldest first
+    if (NumRuns == Runs.size())
+    {
+        vector<Run> Grown( Runs.empty() ? 64 : Runs.size() * 2 );
+        for (unsigned int r = 0; r < NumRuns; r++)
+            Grown[r] = GetRun( r );
+
+        Runs.swap( Grown );
+        OldestRun = 0;
+    }
+
+    Run &Added = Runs[(OldestRun + NumRuns) & (Runs.size() - 1)];
+    Added.Start = Start;
+    Added.FirstStep = HeadStep;
+    Added.Code = Code;
+    NumRuns++;
+
+    Direction = DecodeDirection( Code );
+}
+
+unsigned short SnakeTrajectory::EncodeDirection( const Vector3f &Direction )
+{
+    // Project onto the octahedron |x| + |y| + |z| = 1 and fold the lower half over the upper
+    float Norm = TMath::Abs(Direction.x()) + TMath::Abs(Direction.y()) + TMath::Abs(Direction.z());
+    if (Norm == 0)
+        return EncodeDirection( Vector3f(1, 0, 0) );
+
+    float u = Direction.x() / Norm, v = Direction.y() / Norm;
+    if (Direction.z() < 0)
+    {
+        float FoldedU = (1 - TMath::Abs(v)) * (u >= 0 ? 1 : -1),
+              FoldedV = (1 - TMath::Abs(u)) * (v >= 0 ? 1 : -1);
+        u = FoldedU;
+        v = FoldedV;
+    }
+
+    // 8 bits each, signed normalized to [-127, 127] so zero and the axes are exact
+    int U = TMath::Floor<int>( u * 127 + 0.5f ),
+        V = TMath::Floor<int>( v * 127 + 0.5f );
+    return static_cast<unsigned short>(((U & 0xFF) << 8) | (V & 0xFF));
+}
+
+Vector3f SnakeTrajectory::DecodeDirection( unsigned short Code )
+{
+    float u = static_cast<signed char>(Code >> 8) / 127.0f,
+          v = static_cast<signed char>(Code & 0xFF) / 127.0f,
+          w = 1 - TMath::Abs(u) - TMath::Abs(v);
+
+    // Unfold the lower half
+    if (w < 0)
+    {
+        float UnfoldedU = (1 - TMath::Abs(v)) * (u >= 0 ? 1 : -1),
+              UnfoldedV = (1 - TMath::Abs(u)) * (v >= 0 ? 1 : -1);
+        u = UnfoldedU;
+        v = UnfoldedV;
+    }
+
+    Vector3f Decoded( u, v, w );
+    Decoded.Normalize();
+    return Decoded;
+}
\ No newline at end of file
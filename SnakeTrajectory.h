@@ -0,0 +1,127 @@
+#ifndef SNAKE_TRAJECTORY_H
+#define SNAKE_TRAJECTORY_H
+
+
+
+// ------------------------------------------------------------------------------------
+// ----------------------------------Included headers----------------------------------
+// ------------------------------------------------------------------------------------
+
+// C++ standard library & STL
+#include <cstddef>
+#include <vector>
+
+// Utilities
+#include "Utilities\Matrix.h"
+
+
+// ------------------------------------------------------------------------------------
+// ---------------------------------------Classes--------------------------------------
+// ------------------------------------------------------------------------------------
+
+// Compact snake body for very long snakes. Segments are the last NumSegments points of the
+// head's path, one step apart, so instead of a position per segment only the path is kept:
+// a run per stretch the head moved in one direction, holding the run's first point and its
+// direction quantized to 16 bits. Straight stretches cost one run however long they are,
+// and a body turning at every step costs one run per segment.
+// Each step is taken along the quantized direction and a point k steps into a run is
+// computed as Start + Direction * k both when the head moves and when the body is decoded,
+// so decoded positions are exactly the positions the head passed through. They follow the
+// quantized heading, not the heading passed in: axis directions are exact, others are off
+// by up to about a degree, so the path drifts from a Snake's over long oblique stretches.
+class SnakeTrajectory
+{
+public:
+    SnakeTrajectory();
+
+    // Accessors
+    inline unsigned int GetNumSegments() const;
+    inline unsigned int GetNumRuns() const;
+    inline const Vector3f &GetPosition() const;
+    inline size_t GetReservedBytes() const;
+
+    // Body segment i counting from the head, found by a binary search over the runs
+    Vector3f GetSegmentPosition( unsigned int i ) const;
+    // Decode segments [First, First + Count) head first into coordinate streams, walking the
+    // runs in order
+    void GetSegmentPositions( unsigned int First, unsigned int Count, float *X, float *Y, float *Z ) const;
+
+    // Methods
+    // Lay NumSegments segments out in a line behind the head, keeping the runs' capacity
+    void Reset( const Vector3f &HeadPosition, const Vector3f &Heading, unsigned int NumSegments );
+    // Step the head one unit along Heading, quantized. The tail follows unless Grow is set.
+    void Move( const Vector3f &Heading, bool Grow );
+
+    // 16 bit octahedral encoding of a unit vector, 8 bits signed normalized per coordinate,
+    // and its decoded unit vector
+    static unsigned short EncodeDirection( const Vector3f &Direction );
+    static Vector3f DecodeDirection( unsigned short Code );
+
+private:
+    struct Run
+    {
+        // First point of the run, its direction and its path step number
+        Vector3f Start;
+        unsigned int FirstStep;
+        unsigned short Code;
+    };
+
+    // Ring buffer of runs oldest first, its capacity a power of two
+    std::vector<Run> Runs;
+    unsigned int OldestRun, NumRuns;
+    // Direction of the newest run, decoded
+    Vector3f Direction;
+    // Path step numbers of the head and tail, the body is the steps in between. Step numbers
+    // wrap, only differences of them are used.
+    unsigned int HeadStep, TailStep;
+    Vector3f HeadPosition;
+
+
+    // Run r counting from the oldest
+    inline const Run &GetRun( unsigned int r ) const;
+    // Steps from the tail to the first point of run r. The oldest run may start before the tail.
+    inline unsigned int GetRunOffset( unsigned int r ) const;
+    // Newest run holding step Offset steps from the tail
+    unsigned int FindRun( unsigned int Offset ) const;
+
+    void PushRun( const Vector3f &Start, unsigned short Code );
+};
+
+
+// ------------------------------------------------------------------------------------
+// -----------------------------Inline function definitions----------------------------
+// ------------------------------------------------------------------------------------
+
+unsigned int SnakeTrajectory::GetNumSegments() const
+{
+    return HeadStep - TailStep + 1;
+}
+
+unsigned int SnakeTrajectory::GetNumRuns() const
+{
+    return NumRuns;
+}
+
+const Vector3f &SnakeTrajectory::GetPosition() const
+{
+    return HeadPosition;
+}
+
+size_t SnakeTrajectory::GetReservedBytes() const
+{
+    return Runs.capacity() * sizeof(Run);
+}
+
+const SnakeTrajectory::Run &SnakeTrajectory::GetRun( unsigned int r ) const
+{
+    return Runs[(OldestRun + r) & (Runs.size() - 1)];
+}
+
+unsigned int SnakeTrajectory::GetRunOffset( unsigned int r ) const
+{
+    return r == 0 ? 0 : GetRun( r ).FirstStep - TailStep;
+}
+
+
+
+#endif
\ No newline at end of file
@@ -0,0 +1,74 @@
+// Grows a snake to millions of segments and prints its memory footprint against its length.
+// Usage: SegmentGrowthBenchmark [max segments]
+// Output is CSV, one row per doubling of the length, ready for plotting. Build with
+// TRACK_ALLOCATIONS to get exact live heap bytes besides the resident set size.
+
+
+// ------------------------------------------------------------------------------------
+// ----------------------------------Included headers----------------------------------
+// ------------------------------------------------------------------------------------
+
+// C standard library
+#include <cstdio>
+#include <cstdlib>
+
+// Utilities
+#include "..\Utilities\Matrix.h"
+#include "..\Utilities\MemoryStats.h"
+#include "..\Utilities\AllocationTracker.h"
+
+#include "..\Snake3DObjects.h"
+
+
+// ------------------------------------------------------------------------------------
+// ----------------------------------------Main----------------------------------------
+// ------------------------------------------------------------------------------------
+int main( int argc, char *argv[] )
+{
+    // The snake stops growing at Snake::MaxSegments, so a longer target would never be reached
+    long long Requested = argc > 1 ? atoll( argv[1] ) : 4000000;
+    unsigned int MaxSegments = static_cast<unsigned int>(Requested < 1 ? 1 : Requested > Snake::MaxSegments ? Snake::MaxSegments : Requested);
+
+    // Everything allocated from here on belongs to the snake
+    unsigned long long BaseResident = GetResidentBytes(),
+                       BaseHeap = AllocationTracker::GetThreadStats().LiveBytes;
+
+    const float MoveInterval = 0.01f;
+    Snake *snake = new Snake( Vector3f(0, 0, 0), Vector3f(1, 0, 0), MoveInterval, 40, 1.0f );
+
+    printf( "# Bytes per segment: %u\n", static_cast<unsigned int>(Snake::BytesPerSegment) );
+    printf( "Segments,ResidentBytes,ResidentBytesPerSegment,HeapBytes,HeapBytesPerSegment,BufferReservedBytes,SlackBytesPerSegment,EstimatedBytes\n" );
+
+    for (unsigned int NextReport = 64; snake->GetNumSegments() < MaxSegments; )
+    {
+        // Growth happens as the snake moves
+        snake->IncreaseLength();
+        while (snake->GetPendingGrowth() > 0)
+        {
+            snake->Update( MoveInterval );
+            snake->Move();
+        }
+
+        unsigned int Segments = snake->GetNumSegments();
+        if (Segments < NextReport && Segments < MaxSegments)
+            continue;
+
+        long long Resident = static_cast<long long>(GetResidentBytes() - BaseResident),
+                  Heap = static_cast<long long>(AllocationTracker::GetThreadStats().LiveBytes - BaseHeap);
+
+        SegmentFootprint Footprint = snake->GetSegmentFootprint();
+        printf( "%u,%lld,%.2f,%lld,%.2f,%llu,%u,%llu\n", Segments,
+                Resident, static_cast<double>(Resident)/Segments,
+                Heap, static_cast<double>(Heap)/Segments,
+                static_cast<unsigned long long>(snake->GetReservedBytes()), static_cast<unsigned int>(Footprint.SlackBytes),
+                static_cast<unsigned long long>(Segments) * Footprint.GetTotalBytes() );
+        fflush( stdout );
+
+        NextReport *= 2;
+    }
+
+    printf( "# Peak resident bytes: %llu\n", GetPeakResidentBytes() );
+
+    delete snake;
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,93 @@
+// Tails the shared memory telemetry ring of a running game instance.
+// Usage: TelemetryTail [name] [poll interval ms]
+// The name must match the game's "TelemetryName" setting.
+
+
+// ------------------------------------------------------------------------------------
+// ----------------------------------Included headers----------------------------------
+// ------------------------------------------------------------------------------------
+
+// C standard library
+#include <cstdio>
+#include <cstdlib>
+
+// C++ standard library
+#include <string>
+#include <chrono>
+#include <thread>
+using namespace std;
+
+// Utilities
+#include "..\Utilities\Telemetry.h"
+
+
+// ------------------------------------------------------------------------------------
+// ----------------------------------Static functions----------------------------------
+// ------------------------------------------------------------------------------------
+
+// Wait for the game to create the ring, retrying once a second
+static void Attach( TelemetryReader &Reader, const string &Name )
+{
+    while (!Reader.Open( Name ))
+    {
+        fprintf( stderr, "Waiting for telemetry \"%s\"...\n", Name.c_str() );
+        this_thread::sleep_for( chrono::seconds( 1 ) );
+    }
+}
+
+
+// ------------------------------------------------------------------------------------
+// ----------------------------------------Main----------------------------------------
+// ------------------------------------------------------------------------------------
+int main( int argc, char *argv[] )
+{
+    string Name = argc > 1 ? argv[1] : "Snake3DTelemetry";
+    int PollMilliseconds = argc > 2 ? atoi( argv[2] ) : 100;
+
+    TelemetryReader Reader;
+    Attach( Reader, Name );
+
+    printf( "%10s %10s %9s %9s %9s %9s %10s %10s %12s\n",
+            "Tick", "Time s", "Tick ms", "Update ms", "Render ms", "Coll ms", "Segments", "CollTests", "Memory KB" );
+
+    // Start from the newest record rather than replaying the whole ring
+    unsigned long long Next = Reader.GetWriteIndex();
+    for (;;)
+    {
+        unsigned long long WriteIndex = Reader.GetWriteIndex();
+
+        // Publisher closed or restarted, drop the stale mapping and wait for a new ring
+        if (Reader.IsClosed() || WriteIndex < Next)
+        {
+            Reader.Close();
+            Attach( Reader, Name );
+            Next = Reader.GetWriteIndex();
+            continue;
+        }
+
+        // Fell a full ring behind, skip to the oldest record still available
+        unsigned long long Oldest = Reader.GetOldestIndex();
+        if (Next < Oldest)
+        {
+            printf( "... skipped %llu records\n", Oldest - Next );
+            Next = Oldest;
+        }
+
+        for (; Next < WriteIndex; Next++)
+        {
+            TelemetryRecord Record;
+            if (!Reader.Read( Next, Record ))
+                continue;
+
+            printf( "%10llu %10.3f %9.3f %9.3f %9.3f %9.3f %10u %10u %12llu\n",
+                    Record.Tick, Record.TimeSeconds, Record.TickMilliseconds, Record.UpdateMilliseconds,
+                    Record.RenderMilliseconds, Record.CollisionMilliseconds, Record.Segments,
+                    Record.CollisionTests, Record.MemoryBytes / 1024 );
+        }
+
+        fflush( stdout );
+        this_thread::sleep_for( chrono::milliseconds( PollMilliseconds ) );
+    }
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,75 @@
+// Grows trajectory compressed snake bodies along paths of different curvature and prints
+// their memory footprint and decode speed against the position per segment body.
+// Usage: TrajectoryBenchmark [segments]
+// Output is CSV, one row per path.
+
+
+// ------------------------------------------------------------------------------------
+// ----------------------------------Included headers----------------------------------
+// ------------------------------------------------------------------------------------
+
+// C standard library
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+
+// C++ standard library
+#include <chrono>
+#include <vector>
+using namespace std;
+
+// Utilities
+#include "..\Utilities\Matrix.h"
+
+#include "..\Snake3DObjects.h"
+#include "..\SnakeTrajectory.h"
+
+
+// ------------------------------------------------------------------------------------
+// ----------------------------------------Main----------------------------------------
+// ------------------------------------------------------------------------------------
+int main( int argc, char *argv[] )
+{
+    unsigned int NumSegments = argc > 1 ? static_cast<unsigned int>(atoi( argv[1] )) : 4000000;
+
+    // Heading turn per step in radians, from a straight line to turning at every step
+    const char *PathNames[] = { "Straight", "Gentle", "Winding", "Coiling" };
+    const float TurnRates[] = { 0.0f, 0.0005f, 0.005f, 0.05f };
+
+    // Blocks decoded at once, as a renderer or collision pass would
+    const unsigned int BlockSize = 4096;
+    vector<float> X( BlockSize ), Y( BlockSize ), Z( BlockSize );
+
+    printf( "# Position per segment body: %u bytes per segment\n", static_cast<unsigned int>(Snake::StreamBytesPerSegment) );
+    printf( "Path,Segments,Runs,ReservedBytes,BitsPerSegment,DecodeNsPerSegment\n" );
+
+    SnakeTrajectory Body;
+    for (int Path = 0; Path < 4; Path++)
+    {
+        // Grow from the default body while turning about z, with a slow climb
+        Body.Reset( Vector3f(0.0f), Vector3f(1, 0, 0), 1 );
+        for (unsigned int Step = 1; Step < NumSegments; Step++)
+        {
+            float Angle = TurnRates[Path] * Step;
+            Body.Move( Vector3f( cosf( Angle ), sinf( Angle ), 0.1f ), true );
+        }
+
+        // Decode the whole body in blocks
+        float Checksum = 0;
+        chrono::steady_clock::time_point Begin = chrono::steady_clock::now();
+        for (unsigned int First = 0; First < NumSegments; First += BlockSize)
+        {
+            unsigned int Count = NumSegments - First < BlockSize ? NumSegments - First : BlockSize;
+            Body.GetSegmentPositions( First, Count, &X[0], &Y[0], &Z[0] );
+            Checksum += X[Count - 1];
+        }
+        double Seconds = chrono::duration<double>( chrono::steady_clock::now() - Begin ).count();
+
+        printf( "%s,%u,%u,%llu,%.3f,%.2f\n", PathNames[Path], Body.GetNumSegments(), Body.GetNumRuns(),
+                static_cast<unsigned long long>(Body.GetReservedBytes()),
+                8.0 * Body.GetReservedBytes() / Body.GetNumSegments(), 1e9 * Seconds / NumSegments );
+        fprintf( stderr, "# Checksum %f\n", Checksum );
+    }
+
+    return 0;
+}
\ No newline at end of file
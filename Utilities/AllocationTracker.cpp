@@ -0,0 +1,345 @@
+// ------------------------------------------------------------------------------------
+// ----------------------------------Included headers----------------------------------
+// ------------------------------------------------------------------------------------
+#include "AllocationTracker.h"
+
+// C standard library
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cassert>
+
+// C++ standard library
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <ostream>
+#include <iomanip>
+using namespace std;
+
+#if defined(_WIN32)
+// Windows CRT aligned allocation
+#include <malloc.h>
+#endif
+
+
+// ------------------------------------------------------------------------------------
+// ------------------------------------Tracker state-----------------------------------
+// ------------------------------------------------------------------------------------
+
+// Per-tag counters, shared by all threads. Plain arrays of atomics, so they are usable
+// before static constructors run and the tracker itself never allocates.
+struct TagCounters
+{
+    const char *Name;
+    atomic<unsigned long long> Allocations, Frees;
+    atomic<unsigned long long> AllocatedBytes, LiveBytes, PeakLiveBytes;
+};
+
+static TagCounters Tags[AllocationTracker::MAX_TAGS];
+static atomic<int> NumTags( 1 );
+static atomic<unsigned long long> CheckViolations( 0 );
+static atomic<int> CheckMode( ALLOCATION_CHECK_REPORT );
+
+// Per-thread state, zero initialized without any dynamic initialization
+static thread_local AllocationStats ThreadStats;
+static thread_local int CurrentTag = 0;
+static thread_local bool Checking = false;
+static thread_local bool InHook = false;
+
+static mutex &GetRegistrationLock()
+{
+    static mutex Lock;
+    return Lock;
+}
+
+
+// ------------------------------------------------------------------------------------
+// ------------------------------AllocationTracker Members-----------------------------
+// ------------------------------------------------------------------------------------
+
+bool AllocationTracker::IsEnabled()
+{
+#ifdef TRACK_ALLOCATIONS
+    return true;
+#else
+    return false;
+#endif
+}
+
+int AllocationTracker::RegisterTag( const char *Name )
+{
+    lock_guard<mutex> Lock( GetRegistrationLock() );
+
+    int Count = NumTags.load();
+    for (int i = 1; i < Count; i++)
+    {
+        if (strcmp( Tags[i].Name, Name ) == 0)
+            return i;
+    }
+
+    // Out of tags, attribute to "Untagged"
+    if (Count == MAX_TAGS)
+        return 0;
+
+    Tags[Count].Name = Name;
+    NumTags.store( Count + 1 );
+    return Count;
+}
+
+int AllocationTracker::GetNumTags()
+{
+    return NumTags.load();
+}
+
+const char *AllocationTracker::GetTagName( int Tag )
+{
+    return Tag == 0 ? "Untagged" : Tags[Tag].Name;
+}
+
+AllocationStats AllocationTracker::GetTagStats( int Tag )
+{
+    AllocationStats Stats;
+    Stats.Allocations = Tags[Tag].Allocations.load( memory_order_relaxed );
+    Stats.Frees = Tags[Tag].Frees.load( memory_order_relaxed );
+    Stats.AllocatedBytes = Tags[Tag].AllocatedBytes.load( memory_order_relaxed );
+    Stats.LiveBytes = Tags[Tag].LiveBytes.load( memory_order_relaxed );
+    Stats.PeakLiveBytes = Tags[Tag].PeakLiveBytes.load( memory_order_relaxed );
+    return Stats;
+}
+
+AllocationStats AllocationTracker::GetThreadStats()
+{
+    return ThreadStats;
+}
+
+int AllocationTracker::GetCurrentTag()
+{
+    return CurrentTag;
+}
+
+void AllocationTracker::SetCurrentTag( int Tag )
+{
+    CurrentTag = Tag;
+}
+
+bool AllocationTracker::IsChecking()
+{
+    return Checking;
+}
+
+void AllocationTracker::SetChecking( bool Check )
+{
+    Checking = Check;
+}
+
+void AllocationTracker::SetCheckMode( AllocationCheckMode Mode )
+{
+    CheckMode.store( Mode );
+}
+
+unsigned long long AllocationTracker::GetCheckViolations()
+{
+    return CheckViolations.load();
+}
+
+void AllocationTracker::WriteReport( ostream &Out )
+{
+    if (!IsEnabled())
+    {
+        Out << "Allocation tracking: disabled, build with TRACK_ALLOCATIONS\n";
+        return;
+    }
+
+    Out << "Allocation tracking: " << CheckViolations.load() << " steady-state violations\n";
+    Out << left << setw(28) << "Tag" << right
+        << setw(14) << "Allocations"
+        << setw(14) << "Frees"
+        << setw(16) << "Allocated B"
+        << setw(14) << "Live B"
+        << setw(14) << "Peak live B" << '\n';
+
+    for (int i = 0; i < GetNumTags(); i++)
+    {
+        AllocationStats Stats = GetTagStats( i );
+        Out << left << setw(28) << GetTagName( i ) << right
+            << setw(14) << Stats.Allocations
+            << setw(14) << Stats.Frees
+            << setw(16) << Stats.AllocatedBytes
+            << setw(14) << Stats.LiveBytes
+            << setw(14) << Stats.PeakLiveBytes << '\n';
+    }
+}
+
+
+// ------------------------------------------------------------------------------------
+// -------------------------------Global operator hooks--------------------------------
+// ------------------------------------------------------------------------------------
+#ifdef TRACK_ALLOCATIONS
+
+// Precedes every tracked block. HEADER_SPACE keeps the user pointer max_align_t aligned.
+struct AllocationHeader
+{
+    size_t Size;
+    unsigned short Tag;
+    unsigned short Offset;
+};
+static const size_t HEADER_SPACE = 16;
+static_assert( sizeof(AllocationHeader) <= HEADER_SPACE, "AllocationHeader must fit in HEADER_SPACE" );
+
+static void *PlatformAllocate( size_t Bytes, size_t Alignment )
+{
+#if defined(_WIN32)
+    return _aligned_malloc( Bytes, Alignment );
+#else
+    void *Block = NULL;
+    return posix_memalign( &Block, Alignment, Bytes ) == 0 ? Block : NULL;
+#endif
+}
+
+static void PlatformFree( void *Block )
+{
+#if defined(_WIN32)
+    _aligned_free( Block );
+#else
+    free( Block );
+#endif
+}
+
+static void ReportCheckViolation( size_t Bytes, int Tag )
+{
+    CheckViolations.fetch_add( 1, memory_order_relaxed );
+
+    // stderr is unbuffered, so this doesn't allocate. Allocations it makes anyway bypass tracking.
+    fprintf( stderr, "Steady-state heap allocation: %llu bytes, tag %s\n",
+             static_cast<unsigned long long>(Bytes), AllocationTracker::GetTagName( Tag ) );
+
+    if (CheckMode.load( memory_order_relaxed ) == ALLOCATION_CHECK_ASSERT)
+        assert( !"Heap allocation during a steady-state tick" );
+}
+
+static void *TrackedAllocate( size_t Bytes, size_t Alignment )
+{
+    if (Alignment < HEADER_SPACE)
+        Alignment = HEADER_SPACE;
+
+    // The header sits right before the user pointer, which is Alignment bytes into the block
+    char *Block = static_cast<char *>(PlatformAllocate( Alignment + Bytes, Alignment ));
+    if (Block == NULL)
+        return NULL;
+
+    char *User = Block + Alignment;
+    AllocationHeader *Header = reinterpret_cast<AllocationHeader *>(User - sizeof(AllocationHeader));
+    Header->Size = Bytes;
+    Header->Tag = static_cast<unsigned short>(CurrentTag);
+    Header->Offset = static_cast<unsigned short>(Alignment);
+
+    if (!InHook)
+    {
+        InHook = true;
+
+        TagCounters &Counters = Tags[CurrentTag];
+        Counters.Allocations.fetch_add( 1, memory_order_relaxed );
+        Counters.AllocatedBytes.fetch_add( Bytes, memory_order_relaxed );
+        unsigned long long Live = Counters.LiveBytes.fetch_add( Bytes, memory_order_relaxed ) + Bytes;
+        unsigned long long Peak = Counters.PeakLiveBytes.load( memory_order_relaxed );
+        while (Live > Peak && !Counters.PeakLiveBytes.compare_exchange_weak( Peak, Live, memory_order_relaxed ));
+
+        ThreadStats.Allocations++;
+        ThreadStats.AllocatedBytes += Bytes;
+        ThreadStats.LiveBytes += Bytes;
+        if (ThreadStats.LiveBytes > ThreadStats.PeakLiveBytes)
+            ThreadStats.PeakLiveBytes = ThreadStats.LiveBytes;
+
+        if (Checking)
+            ReportCheckViolation( Bytes, CurrentTag );
+
+        InHook = false;
+    }
+
+    return User;
+}
+
+static void TrackedFree( void *User )
+{
+    if (User == NULL)
+        return;
+
+    AllocationHeader *Header = reinterpret_cast<AllocationHeader *>(static_cast<char *>(User) - sizeof(AllocationHeader));
+    size_t Bytes = Header->Size;
+
+    TagCounters &Counters = Tags[Header->Tag];
+    Counters.Frees.fetch_add( 1, memory_order_relaxed );
+    Counters.LiveBytes.fetch_sub( Bytes, memory_order_relaxed );
+
+    // Thread live bytes go negative when freeing another thread's memory, which nets out
+    ThreadStats.Frees++;
+    ThreadStats.LiveBytes -= Bytes;
+
+    PlatformFree( static_cast<char *>(User) - Header->Offset );
+}
+
+static void *ThrowingAllocate( size_t Bytes, size_t Alignment )
+{
+    // new must return a unique pointer for zero byte requests
+    void *User = TrackedAllocate( Bytes > 0 ? Bytes : 1, Alignment );
+    if (User == NULL)
+        throw bad_alloc();
+
+    return User;
+}
+
+void *operator new( size_t Bytes )
+{
+    return ThrowingAllocate( Bytes, HEADER_SPACE );
+}
+
+void *operator new[]( size_t Bytes )
+{
+    return ThrowingAllocate( Bytes, HEADER_SPACE );
+}
+
+void *operator new( size_t Bytes, const nothrow_t & ) noexcept
+{
+    return TrackedAllocate( Bytes > 0 ? Bytes : 1, HEADER_SPACE );
+}
+
+void *operator new[]( size_t Bytes, const nothrow_t & ) noexcept
+{
+    return TrackedAllocate( Bytes > 0 ? Bytes : 1, HEADER_SPACE );
+}
+
+void *operator new( size_t Bytes, align_val_t Alignment )
+{
+    return ThrowingAllocate( Bytes, static_cast<size_t>(Alignment) );
+}
+
+void *operator new[]( size_t Bytes, align_val_t Alignment )
+{
+    return ThrowingAllocate( Bytes, static_cast<size_t>(Alignment) );
+}
+
+void *operator new( size_t Bytes, align_val_t Alignment, const nothrow_t & ) noexcept
+{
+    return TrackedAllocate( Bytes > 0 ? Bytes : 1, static_cast<size_t>(Alignment) );
+}
+
+void *operator new[]( size_t Bytes, align_val_t Alignment, const nothrow_t & ) noexcept
+{
+    return TrackedAllocate( Bytes > 0 ? Bytes : 1, static_cast<size_t>(Alignment) );
+}
+
+void operator delete( void *User ) noexcept { TrackedFree( User ); }
+void operator delete[]( void *User ) noexcept { TrackedFree( User ); }
+void operator delete( void *User, size_t ) noexcept { TrackedFree( User ); }
+void operator delete[]( void *User, size_t ) noexcept { TrackedFree( User ); }
+void operator delete( void *User, const nothrow_t & ) noexcept { TrackedFree( User ); }
+void operator delete[]( void *User, const nothrow_t & ) noexcept { TrackedFree( User ); }
+void operator delete( void *User, align_val_t ) noexcept { TrackedFree( User ); }
+void operator delete[]( void *User, align_val_t ) noexcept { TrackedFree( User ); }
+void operator delete( void *User, size_t, align_val_t ) noexcept { TrackedFree( User ); }
+void operator delete[]( void *User, size_t, align_val_t ) noexcept { TrackedFree( User ); }
+void operator delete( void *User, align_val_t, const nothrow_t & ) noexcept { TrackedFree( User ); }
+void operator delete[]( void *User, align_val_t, const nothrow_t & ) noexcept { TrackedFree( User ); }
+
+#endif
\ No newline at end of file
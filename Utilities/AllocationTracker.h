@@ -0,0 +1,153 @@
+#ifndef ALLOCATIONTRACKER_H
+#define ALLOCATIONTRACKER_H
+
+
+
+// ------------------------------------------------------------------------------------
+// ----------------------------------Included headers----------------------------------
+// ------------------------------------------------------------------------------------
+
+// C++ standard library
+#include <cstddef>
+#include <ostream>
+
+
+// ------------------------------------------------------------------------------------
+// --------------------------------------Structures------------------------------------
+// ------------------------------------------------------------------------------------
+
+// Heap activity of one thread or one tag
+struct AllocationStats
+{
+    unsigned long long Allocations, Frees;
+    unsigned long long AllocatedBytes, LiveBytes, PeakLiveBytes;
+};
+
+// What happens when a thread allocates inside an AllocationCheckScope
+enum AllocationCheckMode
+{
+    ALLOCATION_CHECK_REPORT,    // Print the size and tag to stderr
+    ALLOCATION_CHECK_ASSERT     // Print, then assert
+};
+
+
+// ------------------------------------------------------------------------------------
+// ---------------------------------------Classes--------------------------------------
+// ------------------------------------------------------------------------------------
+
+// Counts heap allocations made through the global operator new/delete.
+// The operators are only replaced when TRACK_ALLOCATIONS is defined, otherwise every
+// query returns zero and IsEnabled() is false. Each allocation carries a small header
+// recording its size and tag, so live bytes can be attributed to the tagged subsystem
+// that made the allocation regardless of which code frees it.
+class AllocationTracker
+{
+public:
+    enum { MAX_TAGS = 32 };
+
+    // True if the global operators are hooked
+    static bool IsEnabled();
+
+    // Register a subsystem tag, returns the existing index if one with that name exists.
+    // Name must have static storage duration. Tag 0 is "Untagged".
+    static int RegisterTag( const char *Name );
+    static int GetNumTags();
+    static const char *GetTagName( int Tag );
+
+    // Statistics of a tag across all threads, and of the calling thread across all tags
+    static AllocationStats GetTagStats( int Tag );
+    static AllocationStats GetThreadStats();
+
+    // Tag of allocations made by the calling thread
+    static int GetCurrentTag();
+    static void SetCurrentTag( int Tag );
+
+    // Steady-state checking of the calling thread, see AllocationCheckScope
+    static bool IsChecking();
+    static void SetChecking( bool Check );
+    static void SetCheckMode( AllocationCheckMode Mode );
+
+    // Number of allocations caught by steady-state checking so far
+    static unsigned long long GetCheckViolations();
+
+    // Write a table of tags with their allocation counts and live bytes
+    static void WriteReport( std::ostream &Out );
+};
+
+// Attributes allocations made by the calling thread to a tag for the lifetime of the object
+class AllocationTagScope
+{
+public:
+    inline AllocationTagScope( int Tag );
+    inline ~AllocationTagScope();
+
+private:
+    int PreviousTag;
+};
+
+// Turns steady-state checking on or off for the calling thread for the lifetime of the object.
+// Any allocation made while checking is on is reported, or asserted on.
+class AllocationCheckScope
+{
+public:
+    inline AllocationCheckScope( bool Check );
+    inline ~AllocationCheckScope();
+
+private:
+    bool PreviousCheck;
+};
+
+
+// ------------------------------------------------------------------------------------
+// ----------------------------------------Macros--------------------------------------
+// ------------------------------------------------------------------------------------
+
+// Attribute allocations in the rest of the enclosing block to the tag named Name.
+// Allow allocations in the rest of the enclosing block even during a steady-state check,
+// for work that legitimately allocates such as state changes or growth.
+// Both compile out unless TRACK_ALLOCATIONS is defined.
+#ifdef TRACK_ALLOCATIONS
+#define ALLOCATION_TAG( Name ) \
+    static const int AllocationTagID = AllocationTracker::RegisterTag( Name ); \
+    AllocationTagScope CurrentAllocationTag( AllocationTagID )
+#define ALLOCATIONS_ALLOWED() AllocationCheckScope AllowAllocations( false )
+#else
+#define ALLOCATION_TAG( Name )
+#define ALLOCATIONS_ALLOWED()
+#endif
+
+
+// ------------------------------------------------------------------------------------
+// -----------------------------Inline function definitions----------------------------
+// ------------------------------------------------------------------------------------
+
+// -----------------------------AllocationTagScope members-----------------------------
+
+AllocationTagScope::AllocationTagScope( int Tag )
+: PreviousTag(AllocationTracker::GetCurrentTag())
+{
+    AllocationTracker::SetCurrentTag( Tag );
+}
+
+AllocationTagScope::~AllocationTagScope()
+{
+    AllocationTracker::SetCurrentTag( PreviousTag );
+}
+
+
+// ----------------------------AllocationCheckScope members----------------------------
+
+AllocationCheckScope::AllocationCheckScope( bool Check )
+: PreviousCheck(AllocationTracker::IsChecking())
+{
+    AllocationTracker::SetChecking( Check );
+}
+
+AllocationCheckScope::~AllocationCheckScope()
+{
+    AllocationTracker::SetChecking( PreviousCheck );
+}
+
+
+
+#endif
\ No newline at end of file
@@ -0,0 +1,120 @@
+// ------------------------------------------------------------------------------------
+// ----------------------------------Included headers----------------------------------
+// ------------------------------------------------------------------------------------
+#include "BoundingHierarchy.h"
+
+// C++ standard library & STL
+#include <cfloat>
+#include <vector>
+using namespace std;
+
+
+// ------------------------------------------------------------------------------------
+// -----------------------------BoundingHierarchy Members------------------------------
+// ------------------------------------------------------------------------------------
+
+BoundingHierarchy::BoundingHierarchy()
+: Radius(0), NumLeaves(0), SlotMask(0), FirstLive(0), NumLive(0)
+{
+    Coordinates[0] = Coordinates[1] = Coordinates[2] = NULL;
+}
+
+void BoundingHierarchy::Reset( unsigned int NumSlots, float Radius )
+{
+    this->Radius = Radius;
+    NumLeaves = NumSlots / SlotsPerLeaf;
+    SlotMask = NumSlots - 1;
+    FirstLive = 0;
+    NumLive = 0;
+
+    // Everything starts out empty
+    Bounds Empty;
+    for (int Axis = 0; Axis < 3; Axis++)
+    {
+        Empty.Min[Axis] = FLT_MAX;
+        Empty.Max[Axis] = -FLT_MAX;
+    }
+    Nodes.assign( 2 * NumLeaves, Empty );
+}
+
+void BoundingHierarchy::Build( const float *X, const float *Y, const float *Z, unsigned int FirstLive, unsigned int NumLive )
+{
+    Coordinates[0] = X;
+    Coordinates[1] = Y;
+    Coordinates[2] = Z;
+    this->FirstLive = FirstLive;
+    this->NumLive = NumLive;
+
+    // No slots means no tree, and the parent loop below would underflow
+    if (NumLeaves == 0)
+        return;
+
+    // Leaves, then every level above them
+    for (unsigned int Node = NumLeaves; Node < 2 * NumLeaves; Node++)
+        FitLeaf( Node );
+    for (unsigned int Node = NumLeaves - 1; Node >= 1; Node--)
+        FitParent( Node );
+}
+
+void BoundingHierarchy::Refit( unsigned int Slot, unsigned int FirstLive, unsigned int NumLive )
+{
+    this->FirstLive = FirstLive;
+    this->NumLive = NumLive;
+
+    if (NumLeaves == 0)
+        return;
+
+    unsigned int Node = NumLeaves + Slot / SlotsPerLeaf;
+    FitLeaf( Node );
+    for (Node /= 2; Node >= 1; Node /= 2)
+        FitParent( Node );
+}
+
+void BoundingHierarchy::FitLeaf( unsigned int Node )
+{
+    Bounds &Box = Nodes[Node];
+    for (int Axis = 0; Axis < 3; Axis++)
+    {
+        Box.Min[Axis] = FLT_MAX;
+        Box.Max[Axis] = -FLT_MAX;
+    }
+
+    unsigned int FirstSlot = (Node - NumLeaves) * SlotsPerLeaf;
+    bool Empty = true;
+    for (unsigned int Slot = FirstSlot; Slot < FirstSlot + SlotsPerLeaf; Slot++)
+    {
+        if (!IsLive( Slot ))
+            continue;
+
+        Empty = false;
+        for (int Axis = 0; Axis < 3; Axis++)
+        {
+            float c = Coordinates[Axis][Slot];
+            Box.Min[Axis] = c < Box.Min[Axis] ? c : Box.Min[Axis];
+            Box.Max[Axis] = c > Box.Max[Axis] ? c : Box.Max[Axis];
+        }
+    }
+
+    // Grow the centers' box to the spheres'
+    if (!Empty)
+    {
+        for (int Axis = 0; Axis < 3; Axis++)
+        {
+            Box.Min[Axis] -= Radius;
+            Box.Max[Axis] += Radius;
+        }
+    }
+}
+
+void BoundingHierarchy::FitParent( unsigned int Node )
+{
+    Bounds &Box = Nodes[Node];
+    const Bounds &Left = Nodes[2*Node], &Right = Nodes[2*Node + 1];
+
+    // Empty children have Min > Max, so they drop out of the union
+    for (int Axis = 0; Axis < 3; Axis++)
+    {
+        Box.Min[Axis] = Left.Min[Axis] < Right.Min[Axis] ? Left.Min[Axis] : Right.Min[Axis];
+        Box.Max[Axis] = Left.Max[Axis] > Right.Max[Axis] ? Left.Max[Axis] : Right.Max[Axis];
+    }
+}
\ No newline at end of file
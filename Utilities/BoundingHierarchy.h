@@ -0,0 +1,227 @@
+#ifndef BOUNDINGHIERARCHY_H
+#define BOUNDINGHIERARCHY_H
+
+
+
+// ------------------------------------------------------------------------------------
+// ----------------------------------Included headers----------------------------------
+// ------------------------------------------------------------------------------------
+
+// C++ standard library & STL
+#include <cstddef>
+#include <vector>
+
+// Utilities
+#include "Matrix.h"
+
+
+// ------------------------------------------------------------------------------------
+// ---------------------------------------Classes--------------------------------------
+// ------------------------------------------------------------------------------------
+
+// Axis aligned bounding box tree over a ring buffer of spheres stored as coordinate streams
+// owned by the caller. The live spheres are the slots [FirstLive, FirstLive + NumLive)
+// modulo the slot count. Each leaf bounds SlotsPerLeaf consecutive slots. Consecutive
+// spheres of a path lie close together, so leaf boxes stay small. The tree is complete and
+// stored heap style: node 1 is the root and node n has children 2n and 2n + 1. When a slot
+// changes, Refit() updates its leaf and the nodes above it in O(SlotsPerLeaf + log n).
+class BoundingHierarchy
+{
+public:
+    static const unsigned int SlotsPerLeaf = 16;
+    // Bytes of bookkeeping per slot, including its share of the inner nodes
+    static const size_t BytesPerSlot = 2 * 6 * sizeof(float) / SlotsPerLeaf;
+
+    BoundingHierarchy();
+
+    // Size for NumSlots slots, a power of two no less than SlotsPerLeaf, holding spheres of at
+    // most Radius. Memory is reused when NumSlots doesn't grow.
+    void Reset( unsigned int NumSlots, float Radius );
+
+    // Bound the live slots of streams X, Y and Z from scratch. The streams are read again by
+    // Refit(), so they must stay put until the next Build().
+    void Build( const float *X, const float *Y, const float *Z, unsigned int FirstLive, unsigned int NumLive );
+    // Refit after Slot moved or the live range changed over it
+    void Refit( unsigned int Slot, unsigned int FirstLive, unsigned int NumLive );
+
+    // Call Visit( Slot ) for the live slots in leaves overlapping the query volume, a superset
+    // of the spheres touching it. Stop and return true as soon as Visit does.
+    template <typename Visitor>
+    bool QuerySphere( const Vector3f &Center, float Radius, Visitor &Visit ) const;
+    // Ray from Origin along Direction up to MaxDistance. Visit may lower MaxDistance, e.g. to
+    // the nearest hit so far, to skip leaves further away.
+    template <typename Visitor>
+    bool QueryRay( const Vector3f &Origin, const Vector3f &Direction, float &MaxDistance, Visitor &Visit ) const;
+    // Frustum given by planes (a, b, c, d) with a*x + b*y + c*z + d >= 0 inside
+    template <typename Visitor>
+    bool QueryFrustum( const Vector4f Planes[6], Visitor &Visit ) const;
+
+    // Accessors
+    inline size_t GetReservedBytes() const;
+
+private:
+    struct Bounds
+    {
+        float Min[3], Max[3];
+    };
+
+    float Radius;
+    unsigned int NumLeaves, SlotMask, FirstLive, NumLive;
+    const float *Coordinates[3];
+    // Index 0 is unused, leaves are nodes [NumLeaves, 2*NumLeaves)
+    std::vector<Bounds> Nodes;
+
+
+    inline bool IsLive( unsigned int Slot ) const;
+    // Bound the live slots of a leaf, empty bounds have Min > Max
+    void FitLeaf( unsigned int Node );
+    void FitParent( unsigned int Node );
+
+    // Depth first walk over the nodes passing Overlaps( Bounds ), visiting live slots of leaves
+    template <typename Test, typename Visitor>
+    bool Traverse( const Test &Overlaps, Visitor &Visit ) const;
+};
+
+
+// ------------------------------------------------------------------------------------
+// -----------------------------Inline function definitions----------------------------
+// ------------------------------------------------------------------------------------
+
+size_t BoundingHierarchy::GetReservedBytes() const
+{
+    return Nodes.capacity() * sizeof(Bounds);
+}
+
+bool BoundingHierarchy::IsLive( unsigned int Slot ) const
+{
+    return ((Slot - FirstLive) & SlotMask) < NumLive;
+}
+
+
+// ------------------------------------------------------------------------------------
+// ---------------------------Templatized member definitions---------------------------
+// ------------------------------------------------------------------------------------
+
+template <typename Visitor>
+bool BoundingHierarchy::QuerySphere( const Vector3f &Center, float Radius, Visitor &Visit ) const
+{
+    // Squared distance from the center to the box
+    auto Overlaps = [&]( const Bounds &Box ) -> bool
+    {
+        float DistanceSqr = 0;
+        for (int Axis = 0; Axis < 3; Axis++)
+        {
+            float c = Center[Axis];
+            if (c < Box.Min[Axis])
+                DistanceSqr += (Box.Min[Axis] - c) * (Box.Min[Axis] - c);
+            else if (c > Box.Max[Axis])
+                DistanceSqr += (c - Box.Max[Axis]) * (c - Box.Max[Axis]);
+        }
+
+        return DistanceSqr <= Radius * Radius;
+    };
+
+    return Traverse( Overlaps, Visit );
+}
+
+template <typename Visitor>
+bool BoundingHierarchy::QueryRay( const Vector3f &Origin, const Vector3f &Direction, float &MaxDistance, Visitor &Visit ) const
+{
+    // Slab test, clipping [0, MaxDistance] against each axis
+    auto Overlaps = [&]( const Bounds &Box ) -> bool
+    {
+        float Near = 0, Far = MaxDistance;
+        for (int Axis = 0; Axis < 3; Axis++)
+        {
+            float o = Origin[Axis], d = Direction[Axis];
+            if (d == 0)
+            {
+                if (o < Box.Min[Axis] || o > Box.Max[Axis])
+                    return false;
+                continue;
+            }
+
+            float Inverse = 1 / d,
+                  Enter = (Box.Min[Axis] - o) * Inverse,
+                  Exit = (Box.Max[Axis] - o) * Inverse;
+            if (Enter > Exit)
+            {
+                float Swap = Enter;
+                Enter = Exit;
+                Exit = Swap;
+            }
+
+            Near = Enter > Near ? Enter : Near;
+            Far = Exit < Far ? Exit : Far;
+            if (Near > Far)
+                return false;
+        }
+
+        return true;
+    };
+
+    return Traverse( Overlaps, Visit );
+}
+
+template <typename Visitor>
+bool BoundingHierarchy::QueryFrustum( const Vector4f Planes[6], Visitor &Visit ) const
+{
+    // Outside once the corner furthest along a plane's normal is behind it
+    auto Overlaps = [&]( const Bounds &Box ) -> bool
+    {
+        for (int i = 0; i < 6; i++)
+        {
+            const Vector4f &Plane = Planes[i];
+            float Distance = Plane.w();
+            for (int Axis = 0; Axis < 3; Axis++)
+                Distance += Plane[Axis] * (Plane[Axis] >= 0 ? Box.Max[Axis] : Box.Min[Axis]);
+
+            if (Distance < 0)
+                return false;
+        }
+
+        return true;
+    };
+
+    return Traverse( Overlaps, Visit );
+}
+
+template <typename Test, typename Visitor>
+bool BoundingHierarchy::Traverse( const Test &Overlaps, Visitor &Visit ) const
+{
+    if (Nodes.empty())
+        return false;
+
+    // One pending sibling per level at most
+    unsigned int Stack[64];
+    int Top = 0;
+    Stack[Top++] = 1;
+
+    while (Top > 0)
+    {
+        unsigned int Node = Stack[--Top];
+        const Bounds &Box = Nodes[Node];
+        if (Box.Min[0] > Box.Max[0] || !Overlaps( Box ))
+            continue;
+
+        if (Node < NumLeaves)
+        {
+            Stack[Top++] = 2*Node + 1;
+            Stack[Top++] = 2*Node;
+            continue;
+        }
+
+        unsigned int FirstSlot = (Node - NumLeaves) * SlotsPerLeaf;
+        for (unsigned int Slot = FirstSlot; Slot < FirstSlot + SlotsPerLeaf; Slot++)
+        {
+            if (IsLive( Slot ) && Visit( Slot ))
+                return true;
+        }
+    }
+
+    return false;
+}
+
+
+
+#endif
\ No newline at end of file
@@ -11,6 +11,13 @@
 // ----------------------------------Included headers----------------------------------
 // ------------------------------------------------------------------------------------
 #include <map>
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cassert>
+
+#include "HashedID.h"
+#include "Exceptions.h"
 
 
 // ------------------------------------------------------------------------------------
@@ -53,6 +60,140 @@ private:
 	AssociationMap Associations;
 };
 
+// Factory keyed by hashed IDs.
+// Creators live in an open-addressing table indexed by the ID hash, so creating a product
+// is an integer probe rather than a string comparison. Registering two names that hash
+// to the same value throws, debug builds also check names on lookup.
+template <class AbstractProduct, typename ProductCreator>
+class Factory<AbstractProduct, HashedID, ProductCreator>
+{
+public:
+	Factory()
+	: NumUsed(0), NumDeleted(0)
+	{
+		Table.resize(16);
+	}
+
+	// Register a creation function with a type ID
+	bool Register(const HashedID &ID, const ProductCreator Creator)
+	{
+		Entry *Existing = Find(ID);
+		if (Existing != NULL)
+		{
+			if (strcmp(Existing->Name, ID.GetName()) != 0)
+				throw LogicException(std::string() + "Factory ID \"" + ID.GetName() + "\" has the same hash as \"" + Existing->Name + "\".");
+
+			return false;
+		}
+
+		// Keep at least half the table empty so probe sequences stay short and terminate
+		if ((NumUsed + NumDeleted + 1) * 2 > Table.size())
+			Rehash((NumUsed + 1) * 4 > Table.size() ? Table.size() * 2 : Table.size());
+
+		Insert(ID.GetHash(), ID.GetName(), Creator);
+		return true;
+	}
+	// Unregister a type
+	bool Unregister(const HashedID &ID)
+	{
+		Entry *Existing = Find(ID);
+		if (Existing == NULL)
+			return false;
+
+		// Leave a tombstone so probe sequences running through the slot stay intact
+		Existing->State = DELETED;
+		NumUsed--;
+		NumDeleted++;
+		return true;
+	}
+	// Create a product based on its type ID
+	AbstractProduct *CreateProduct(const HashedID &ID)
+	{
+		Entry *Found = Find(ID);
+		if (Found == NULL)
+			return NULL;
+
+		assert(strcmp(Found->Name, ID.GetName()) == 0 && "Factory ID hash collision");
+		return (Found->Creator)();
+	}
+	// Get the IDs of all registered types
+	std::vector<HashedID> GetRegisteredIDs() const
+	{
+		std::vector<HashedID> IDs;
+		for (unsigned int i = 0; i < Table.size(); i++)
+		{
+			if (Table[i].State == USED)
+				IDs.push_back(HashedID(Table[i].Name));
+		}
+
+		return IDs;
+	}
+
+private:
+	enum EntryState { EMPTY, USED, DELETED };
+
+	struct Entry
+	{
+		Entry()
+		: Hash(0), Name(NULL), Creator(NULL), State(EMPTY)
+		{
+		}
+
+		unsigned int Hash;
+		const char *Name;
+		ProductCreator Creator;
+		EntryState State;
+	};
+
+	// Power of two sized, probed linearly from the hash
+	std::vector<Entry> Table;
+	unsigned int NumUsed, NumDeleted;
+
+	Entry *Find(const HashedID &ID)
+	{
+		unsigned int Mask = static_cast<unsigned int>(Table.size()) - 1;
+		for (unsigned int i = ID.GetHash() & Mask; ; i = (i + 1) & Mask)
+		{
+			if (Table[i].State == EMPTY)
+				return NULL;
+			if (Table[i].State == USED && Table[i].Hash == ID.GetHash())
+				return &Table[i];
+		}
+	}
+
+	void Insert(unsigned int Hash, const char *Name, const ProductCreator Creator)
+	{
+		unsigned int Mask = static_cast<unsigned int>(Table.size()) - 1, i = Hash & Mask;
+		while (Table[i].State == USED)
+			i = (i + 1) & Mask;
+
+		if (Table[i].State == DELETED)
+			NumDeleted--;
+
+		Table[i].Hash = Hash;
+		Table[i].Name = Name;
+		Table[i].Creator = Creator;
+		Table[i].State = USED;
+		NumUsed++;
+	}
+
+	// Rebuild the table with Size entries, dropping tombstones
+	void Rehash(size_t Size)
+	{
+		std::vector<Entry> Old;
+		Old.swap(Table);
+		Table.resize(Size);
+		NumUsed = 0;
+		NumDeleted = 0;
+
+		for (unsigned int i = 0; i < Old.size(); i++)
+		{
+			if (Old[i].State == USED)
+				Insert(Old[i].Hash, Old[i].Name, Old[i].Creator);
+		}
+	}
+};
+
 // Helper class used to register concrete product IDs with a factory
 template <class AbstractProduct, class ConcreteProduct, typename IDType>
 class FactoryRegistrar
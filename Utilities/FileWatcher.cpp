@@ -0,0 +1,160 @@
+// ------------------------------------------------------------------------------------
+// ----------------------------------Included headers----------------------------------
+// ------------------------------------------------------------------------------------
+#include "FileWatcher.h"
+
+// C++ standard library & STL
+#include <string>
+using namespace std;
+
+#if defined(__linux__)
+// inotify
+#include <sys/inotify.h>
+#include <unistd.h>
+#elif defined(_WIN32)
+// Windows
+#include <Windows.h>
+#else
+// POSIX
+#include <sys/stat.h>
+#endif
+
+// Utilities
+#include "Exceptions.h"
+#include "Profiler.h"
+
+
+// ------------------------------------------------------------------------------------
+// ---------------------------------FileWatcher Members--------------------------------
+// ------------------------------------------------------------------------------------
+
+FileWatcher::FileWatcher()
+: Watching(false)
+{
+#if defined(__linux__)
+    NotifyDescriptor = -1;
+#else
+    LastModified = -1;
+    PollSeconds = 0;
+    NextPollTicks = 0;
+#endif
+}
+
+FileWatcher::~FileWatcher()
+{
+    Stop();
+}
+
+void FileWatcher::Watch( const char *FilePath, double PollSeconds )
+{
+    Stop();
+
+    Path = FilePath;
+
+#if defined(__linux__)
+    // Watch the directory, an editor may replace the file rather than write to it
+    string Directory = ".";
+    size_t Separator = Path.find_last_of( "/\\" );
+    if (Separator == string::npos)
+        FileName = Path;
+    else
+    {
+        Directory = Path.substr( 0, Separator + 1 );
+        FileName = Path.substr( Separator + 1 );
+    }
+
+    NotifyDescriptor = inotify_init1( IN_NONBLOCK | IN_CLOEXEC );
+    if (NotifyDescriptor < 0)
+        throw FileIOException( Path, "Failed to create an inotify instance." );
+
+    // Only completed writes and renames, a file that was just created may still be empty
+    if (inotify_add_watch( NotifyDescriptor, Directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO ) < 0)
+    {
+        close( NotifyDescriptor );
+        NotifyDescriptor = -1;
+        throw FileIOException( Path, "Failed to watch the file's directory." );
+    }
+#else
+    this->PollSeconds = PollSeconds;
+    NextPollTicks = 0;
+    LastModified = GetModifiedTime( FilePath );
+    if (LastModified < 0)
+        throw FileNotFoundException( Path );
+#endif
+
+    Watching = true;
+}
+
+void FileWatcher::Stop()
+{
+#if defined(__linux__)
+    if (NotifyDescriptor >= 0)
+        close( NotifyDescriptor );
+    NotifyDescriptor = -1;
+#endif
+
+    Watching = false;
+}
+
+bool FileWatcher::HasChanged()
+{
+    if (!Watching)
+        return false;
+
+#if defined(__linux__)
+    bool Changed = false;
+
+    // Drain every pending event, the descriptor is non-blocking
+    alignas(inotify_event) char Buffer[4096];
+    for (;;)
+    {
+        ssize_t Read = read( NotifyDescriptor, Buffer, sizeof(Buffer) );
+        if (Read <= 0)
+            break;
+
+        for (ssize_t Offset = 0; Offset < Read; )
+        {
+            const inotify_event *Event = reinterpret_cast<const inotify_event *>(Buffer + Offset);
+            if (Event->len > 0 && FileName == Event->name)
+                Changed = true;
+
+            Offset += sizeof(inotify_event) + Event->len;
+        }
+    }
+
+    return Changed;
+#else
+    // Checking the modification time costs a system call, so it is rate limited
+    long long Now = Profiler::GetTicks();
+    if (Now < NextPollTicks)
+        return false;
+    NextPollTicks = Now + static_cast<long long>(PollSeconds / Profiler::GetSecondsPerTick());
+
+    // The file may be briefly missing while an editor replaces it
+    long long Modified = GetModifiedTime( Path.c_str() );
+    if (Modified < 0 || Modified == LastModified)
+        return false;
+
+    LastModified = Modified;
+    return true;
+#endif
+}
+
+#if !defined(__linux__)
+long long FileWatcher::GetModifiedTime( const char *FilePath )
+{
+#if defined(_WIN32)
+    WIN32_FILE_ATTRIBUTE_DATA Attributes;
+    if (!GetFileAttributesExA( FilePath, GetFileExInfoStandard, &Attributes ))
+        return -1;
+
+    return (static_cast<long long>(Attributes.ftLastWriteTime.dwHighDateTime) << 32) | Attributes.ftLastWriteTime.dwLowDateTime;
+#else
+    struct stat Status;
+    if (stat( FilePath, &Status ) != 0)
+        return -1;
+
+    return static_cast<long long>(Status.st_mtime);
+#endif
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,78 @@
+#ifndef FILEWATCHER_H
+#define FILEWATCHER_H
+
+
+
+// ------------------------------------------------------------------------------------
+// ----------------------------------Included headers----------------------------------
+// ------------------------------------------------------------------------------------
+
+// C++ standard library & STL
+#include <string>
+
+
+// ------------------------------------------------------------------------------------
+// ---------------------------------------Classes--------------------------------------
+// ------------------------------------------------------------------------------------
+
+// Reports when a file has been written, without blocking, so it can be polled once per tick.
+// Uses inotify on Linux, watching the file's directory so editors that save by replacing the
+// file are caught too. Elsewhere the modification time is polled at most every PollSeconds.
+// An editor may save in several steps, so one save can be reported on more than one poll.
+class FileWatcher
+{
+public:
+    FileWatcher();
+    ~FileWatcher();
+
+    // Start watching FilePath, stop watching any file watched before
+    // - May throw: FileIOException
+    void Watch( const char *FilePath, double PollSeconds = 0.25 );
+    void Stop();
+
+    // True if the file changed since the last call
+    bool HasChanged();
+
+    // Accessors
+    inline const std::string &GetPath() const;
+    inline bool IsWatching() const;
+
+private:
+    std::string Path;
+    bool Watching;
+
+#if defined(__linux__)
+    // File name within the watched directory, and the inotify instance
+    std::string FileName;
+    int NotifyDescriptor;
+#else
+    long long LastModified;
+    double PollSeconds;
+    long long NextPollTicks;
+
+    static long long GetModifiedTime( const char *FilePath );
+#endif
+
+    // Disable copying
+    FileWatcher( const FileWatcher & );
+    FileWatcher &operator = ( const FileWatcher & );
+};
+
+
+// ------------------------------------------------------------------------------------
+// -----------------------------Inline function definitions----------------------------
+// ------------------------------------------------------------------------------------
+
+const std::string &FileWatcher::GetPath() const
+{
+    return Path;
+}
+
+bool FileWatcher::IsWatching() const
+{
+    return Watching;
+}
+
+
+
+#endif
\ No newline at end of file
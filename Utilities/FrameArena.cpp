@@ -0,0 +1,102 @@
+// ------------------------------------------------------------------------------------
+// ----------------------------------Included headers----------------------------------
+// ------------------------------------------------------------------------------------
+#include "FrameArena.h"
+
+// C++ standard library & STL
+#include <cstddef>
+#include <new>
+#include <vector>
+#include <ostream>
+using namespace std;
+
+// Utilities
+#include "AllocationTracker.h"
+
+
+// ------------------------------------------------------------------------------------
+// ---------------------------------FrameArena Members---------------------------------
+// ------------------------------------------------------------------------------------
+
+FrameArena::FrameArena( size_t BytesPerFrame )
+: Current(0), Capacity(BytesPerFrame), HighWater(0), Overflows(0)
+{
+    for (int i = 0; i < 2; i++)
+    {
+        Buffers[i].Memory = static_cast<char *>(::operator new( Capacity ));
+        Buffers[i].Used = 0;
+        Buffers[i].OverflowBytes = 0;
+    }
+}
+
+FrameArena::~FrameArena()
+{
+    for (int i = 0; i < 2; i++)
+    {
+        ReleaseOverflow( Buffers[i] );
+        ::operator delete( Buffers[i].Memory );
+    }
+}
+
+void FrameArena::BeginFrame()
+{
+    Current ^= 1;
+
+    FrameBuffer &Buffer = Buffers[Current];
+    Buffer.Used = 0;
+    ReleaseOverflow( Buffer );
+}
+
+void *FrameArena::Allocate( size_t Bytes, size_t Alignment )
+{
+    FrameBuffer &Buffer = Buffers[Current];
+
+    // Round the offset up to the alignment, which must be a power of two
+    size_t Start = (Buffer.Used + Alignment - 1) & ~(Alignment - 1);
+    if (Start + Bytes > Capacity)
+        return AllocateOverflow( Bytes, Alignment );
+
+    Buffer.Used = Start + Bytes;
+
+    size_t Used = Buffer.Used + Buffer.OverflowBytes;
+    if (Used > HighWater)
+        HighWater = Used;
+
+    return Buffer.Memory + Start;
+}
+
+void *FrameArena::AllocateOverflow( size_t Bytes, size_t Alignment )
+{
+    ALLOCATION_TAG( "FrameArena" );
+
+    FrameBuffer &Buffer = Buffers[Current];
+
+    // operator new only guarantees max_align_t alignment, over-allocate for anything stricter
+    size_t Padding = Alignment > alignof(max_align_t) ? Alignment : 0;
+    char *Block = static_cast<char *>(::operator new( Bytes + Padding ));
+    Buffer.Overflow.push_back( Block );
+    Buffer.OverflowBytes += Bytes;
+    Overflows++;
+
+    size_t Used = Buffer.Used + Buffer.OverflowBytes;
+    if (Used > HighWater)
+        HighWater = Used;
+
+    size_t Address = reinterpret_cast<size_t>(Block);
+    return Block + (((Address + Alignment - 1) & ~(Alignment - 1)) - Address);
+}
+
+void FrameArena::ReleaseOverflow( FrameBuffer &Buffer )
+{
+    for (unsigned int i = 0; i < Buffer.Overflow.size(); i++)
+        ::operator delete( Buffer.Overflow[i] );
+
+    Buffer.Overflow.clear();
+    Buffer.OverflowBytes = 0;
+}
+
+void FrameArena::WriteReport( ostream &Out ) const
+{
+    Out << "Frame arena: " << HighWater << " of " << Capacity << " bytes high water, "
+        << Overflows << " overflow allocations\n";
+}
\ No newline at end of file
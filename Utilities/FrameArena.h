@@ -0,0 +1,156 @@
+#ifndef FRAMEARENA_H
+#define FRAMEARENA_H
+
+
+
+// ------------------------------------------------------------------------------------
+// ----------------------------------Included headers----------------------------------
+// ------------------------------------------------------------------------------------
+
+// C++ standard library & STL
+#include <cstddef>
+#include <vector>
+#include <ostream>
+
+
+// ------------------------------------------------------------------------------------
+// ---------------------------------------Classes--------------------------------------
+// ------------------------------------------------------------------------------------
+
+// Linear allocator for data that only lives for a frame or two.
+// Allocation bumps an offset into a preallocated buffer and individual frees are no-ops.
+// There are two buffers used on alternate frames, so memory handed out during a frame
+// stays valid through the next one (e.g. for a render thread lagging a frame behind).
+// Requests that don't fit spill to the heap and are counted, raise the capacity until
+// the overflow count in the report stays at zero.
+class FrameArena
+{
+public:
+    // Reserves BytesPerFrame for each of the two buffers
+    FrameArena( size_t BytesPerFrame );
+    ~FrameArena();
+
+    // Start a new frame, reusing the buffer of the frame before last
+    void BeginFrame();
+
+    // Uninitialized memory valid until BeginFrame() has been called twice. Never returns NULL.
+    void *Allocate( size_t Bytes, size_t Alignment = alignof(std::max_align_t) );
+
+    // Accessors
+    inline size_t GetCapacity() const;
+    inline size_t GetUsedBytes() const;
+    inline size_t GetHighWaterBytes() const;
+    inline unsigned long long GetOverflowCount() const;
+
+    // Write capacity, high water mark and overflow count
+    void WriteReport( std::ostream &Out ) const;
+
+private:
+    struct FrameBuffer
+    {
+        char *Memory;
+        size_t Used;
+
+        // Heap blocks for requests that didn't fit, freed when the buffer is reused
+        std::vector<void *> Overflow;
+        size_t OverflowBytes;
+    };
+
+    FrameBuffer Buffers[2];
+    int Current;
+
+    size_t Capacity, HighWater;
+    unsigned long long Overflows;
+
+
+    void *AllocateOverflow( size_t Bytes, size_t Alignment );
+    void ReleaseOverflow( FrameBuffer &Buffer );
+
+    // Disable copying
+    FrameArena( const FrameArena & );
+    FrameArena &operator = ( const FrameArena & );
+};
+
+
+// ------------------------------------------------------------------------------------
+// --------------------Templatized class declarations & definitions--------------------
+// ------------------------------------------------------------------------------------
+
+// STL allocator adaptor drawing from a FrameArena. Containers using it must not outlive
+// the arena memory, i.e. the frame after the one they were created in.
+template <typename T>
+class FrameAllocator
+{
+public:
+    typedef T value_type;
+
+    FrameAllocator( FrameArena &Arena )
+    : Arena(&Arena)
+    {
+    }
+
+    template <typename U>
+    FrameAllocator( const FrameAllocator<U> &Other )
+    : Arena(Other.GetArena())
+    {
+    }
+
+    T *allocate( size_t Count )
+    {
+        return static_cast<T *>(Arena->Allocate( Count * sizeof(T), alignof(T) ));
+    }
+
+    // Memory is reclaimed wholesale by the arena
+    void deallocate( T *Pointer, size_t Count )
+    {
+    }
+
+    FrameArena *GetArena() const
+    {
+        return Arena;
+    }
+
+    template <typename U>
+    bool operator == ( const FrameAllocator<U> &rhs ) const
+    {
+        return Arena == rhs.GetArena();
+    }
+
+    template <typename U>
+    bool operator != ( const FrameAllocator<U> &rhs ) const
+    {
+        return Arena != rhs.GetArena();
+    }
+
+private:
+    FrameArena *Arena;
+};
+
+
+// ------------------------------------------------------------------------------------
+// -----------------------------Inline function definitions----------------------------
+// ------------------------------------------------------------------------------------
+
+size_t FrameArena::GetCapacity() const
+{
+    return Capacity;
+}
+
+size_t FrameArena::GetUsedBytes() const
+{
+    return Buffers[Current].Used + Buffers[Current].OverflowBytes;
+}
+
+size_t FrameArena::GetHighWaterBytes() const
+{
+    return HighWater;
+}
+
+unsigned long long FrameArena::GetOverflowCount() const
+{
+    return Overflows;
+}
+
+
+
+#endif
\ No newline at end of file
@@ -0,0 +1,82 @@
+#ifndef HASHEDID_H
+#define HASHEDID_H
+
+
+
+// ------------------------------------------------------------------------------------
+// ---------------------------------Function prototypes--------------------------------
+// ------------------------------------------------------------------------------------
+
+// 32-bit FNV-1a hash of a null terminated string, usable in constant expressions
+inline constexpr unsigned int HashString( const char *String, unsigned int Hash = 2166136261u );
+
+
+// ------------------------------------------------------------------------------------
+// ---------------------------------------Classes--------------------------------------
+// ------------------------------------------------------------------------------------
+
+// Identifier compared by the hash of its name. The name is kept for debugging and
+// collision detection and must outlive the ID, typically it is a string literal.
+// Declare IDs constexpr to have the hash computed at compile time.
+class HashedID
+{
+public:
+    inline constexpr HashedID( const char *Name );
+
+    // Accessors
+    inline constexpr unsigned int GetHash() const;
+    inline constexpr const char *GetName() const;
+
+    // Comparison, by hash only
+    inline constexpr bool operator == ( const HashedID &rhs ) const;
+    inline constexpr bool operator != ( const HashedID &rhs ) const;
+    inline constexpr bool operator < ( const HashedID &rhs ) const;
+
+private:
+    unsigned int Hash;
+    const char *Name;
+};
+
+
+// ------------------------------------------------------------------------------------
+// -----------------------------Inline function definitions----------------------------
+// ------------------------------------------------------------------------------------
+
+constexpr unsigned int HashString( const char *String, unsigned int Hash )
+{
+    return *String == 0 ? Hash : HashString( String + 1, (Hash ^ static_cast<unsigned char>(*String)) * 16777619u );
+}
+
+constexpr HashedID::HashedID( const char *Name )
+: Hash(HashString( Name )), Name(Name)
+{
+}
+
+constexpr unsigned int HashedID::GetHash() const
+{
+    return Hash;
+}
+
+constexpr const char *HashedID::GetName() const
+{
+    return Name;
+}
+
+constexpr bool HashedID::operator == ( const HashedID &rhs ) const
+{
+    return Hash == rhs.Hash;
+}
+
+constexpr bool HashedID::operator != ( const HashedID &rhs ) const
+{
+    return Hash != rhs.Hash;
+}
+
+constexpr bool HashedID::operator < ( const HashedID &rhs ) const
+{
+    return Hash < rhs.Hash;
+}
+
+
+
+#endif
\ No newline at end of file
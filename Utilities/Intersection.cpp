@@ -0,0 +1,132 @@
+// ------------------------------------------------------------------------------------
+// ----------------------------------Included headers----------------------------------
+// ------------------------------------------------------------------------------------
+#include "Intersection.h"
+
+// Utilities
+#include "TMath.h"
+
+
+// ------------------------------------------------------------------------------------
+// --------------------------------Function definitions--------------------------------
+// ------------------------------------------------------------------------------------
+
+// Both tests solve |Start - Center + t*(End - Start)|^2 = Distance^2 for t, written as
+// a*t^2 + 2*b*t + c = 0
+
+bool SweepSphereSphere( const Vector3f &Start, const Vector3f &End, float Radius,
+                        const Vector3f &Center, float OtherRadius, float &TimeOfImpact )
+{
+    Vector3f Move = End - Start,
+             Offset = Start - Center;
+
+    // Already touching
+    float c = VectorDot( Offset, Offset ) - TMath::Sqr(Radius + OtherRadius);
+    if (c <= 0)
+    {
+        TimeOfImpact = 0;
+        return true;
+    }
+
+    // Not moving, or moving away
+    float a = VectorDot( Move, Move ),
+          b = VectorDot( Offset, Move );
+    if (a == 0 || b >= 0)
+        return false;
+
+    // Missing
+    float Discriminant = b*b - a*c;
+    if (Discriminant < 0)
+        return false;
+
+    // First root is where the spheres start touching
+    float t = (-b - TMath::Sqrt(Discriminant)) / a;
+    if (t > 1)
+        return false;
+
+    TimeOfImpact = t;
+    return true;
+}
+
+bool SweepSphereOutOfSphere( const Vector3f &Start, const Vector3f &End, float Radius,
+                             const Vector3f &Center, float BoundaryRadius, float &TimeOfImpact )
+{
+    // The moving sphere is inside while its center is within Distance of Center
+    float Distance = BoundaryRadius - Radius;
+    Vector3f Move = End - Start,
+             Offset = Start - Center;
+
+    // Already outside
+    float c = VectorDot( Offset, Offset ) - TMath::Sqr(Distance);
+    if (Distance < 0 || c > 0)
+    {
+        TimeOfImpact = 0;
+        return true;
+    }
+
+    // The inside is convex, so a move ending inside never left it
+    if ((End - Center).GetMagnitudeSqr() <= TMath::Sqr(Distance))
+        return false;
+
+    // Second root is where the center crosses out, Start being inside
+    float a = VectorDot( Move, Move ),
+          b = VectorDot( Offset, Move );
+    float t = (-b + TMath::Sqrt(b*b - a*c)) / a;
+
+    TimeOfImpact = t < 0 ? 0 : (t > 1 ? 1 : t);
+    return true;
+}
+
+bool RaySphere( const Vector3f &Origin, const Vector3f &Direction, const Vector3f &Center, float Radius, float &Distance )
+{
+    Vector3f Offset = Origin - Center;
+
+    // Inside
+    float c = VectorDot( Offset, Offset ) - Radius*Radius;
+    if (c <= 0)
+    {
+        Distance = 0;
+        return true;
+    }
+
+    // Pointing away
+    float b = VectorDot( Offset, Direction );
+    if (b >= 0)
+        return false;
+
+    // Missing
+    float Discriminant = b*b - c;
+    if (Discriminant < 0)
+        return false;
+
+    Distance = -b - TMath::Sqrt(Discriminant);
+    return true;
+}
+
+void ExtractFrustumPlanes( const float *ClipMatrix, Vector4f Planes[6] )
+{
+    // Gribb & Hartmann: each plane is the last row of the clip matrix plus or minus another
+    for (int i = 0; i < 6; i++)
+    {
+        int Row = i / 2;
+        float Sign = i % 2 == 0 ? 1.0f : -1.0f;
+
+        for (int Column = 0; Column < 4; Column++)
+            Planes[i][Column] = ClipMatrix[Column*4 + 3] + Sign * ClipMatrix[Column*4 + Row];
+
+        float Length = TMath::Sqrt( TMath::Sqr(Planes[i].x()) + TMath::Sqr(Planes[i].y()) + TMath::Sqr(Planes[i].z()) );
+        if (Length > 0)
+            Planes[i] *= 1 / Length;
+    }
+}
+
+bool SphereInFrustum( const Vector4f Planes[6], const Vector3f &Center, float Radius )
+{
+    for (int i = 0; i < 6; i++)
+    {
+        if (Planes[i].x()*Center.x() + Planes[i].y()*Center.y() + Planes[i].z()*Center.z() + Planes[i].w() < -Radius)
+            return false;
+    }
+
+    return true;
+}
\ No newline at end of file
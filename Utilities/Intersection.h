@@ -0,0 +1,43 @@
+#ifndef INTERSECTION_H
+#define INTERSECTION_H
+
+
+
+// ------------------------------------------------------------------------------------
+// ----------------------------------Included headers----------------------------------
+// ------------------------------------------------------------------------------------
+
+// Utilities
+#include "Matrix.h"
+
+
+// ------------------------------------------------------------------------------------
+// ---------------------------------Function prototypes--------------------------------
+// ------------------------------------------------------------------------------------
+
+// Swept sphere tests. A sphere of Radius moves in a straight line from Start to End over one
+// step, sweeping out a capsule. On a hit TimeOfImpact is the fraction of the step in [0, 1]
+// at which the sphere first touches, 0 if it already touches at Start.
+
+// Moving sphere against a sphere of OtherRadius at Center
+bool SweepSphereSphere( const Vector3f &Start, const Vector3f &End, float Radius,
+                        const Vector3f &Center, float OtherRadius, float &TimeOfImpact );
+
+// Moving sphere against the inside of a sphere of BoundaryRadius at Center, hits once any
+// part of the moving sphere is outside it
+bool SweepSphereOutOfSphere( const Vector3f &Start, const Vector3f &End, float Radius,
+                             const Vector3f &Center, float BoundaryRadius, float &TimeOfImpact );
+
+// Ray from Origin along unit Direction against a sphere. Distance is set to the distance
+// along the ray of the first hit, 0 if Origin is inside the sphere.
+bool RaySphere( const Vector3f &Origin, const Vector3f &Direction, const Vector3f &Center, float Radius, float &Distance );
+
+// Frustum planes (a, b, c, d) of a column-major OpenGL clip matrix, projection times
+// modelview, normalized and facing inwards so a*x + b*y + c*z + d >= 0 inside
+void ExtractFrustumPlanes( const float *ClipMatrix, Vector4f Planes[6] );
+// Whether any part of a sphere is inside the frustum
+bool SphereInFrustum( const Vector4f Planes[6], const Vector3f &Center, float Radius );
+
+
+
+#endif
\ No newline at end of file
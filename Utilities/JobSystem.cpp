@@ -0,0 +1,280 @@
+// ------------------------------------------------------------------------------------
+// ----------------------------------Included headers----------------------------------
+// ------------------------------------------------------------------------------------
+#include "JobSystem.h"
+
+// C++ standard library & STL
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+using namespace std;
+
+#if defined(_WIN32)
+// Windows
+#include <Windows.h>
+#elif defined(__linux__)
+// POSIX threads
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+
+// ------------------------------------------------------------------------------------
+// ------------------------------------Thread state------------------------------------
+// ------------------------------------------------------------------------------------
+
+// Job system the calling thread belongs to, and the index of the deque it owns
+static thread_local const JobSystem *CurrentSystem = NULL;
+static thread_local int CurrentQueue = 0;
+
+
+// ------------------------------------------------------------------------------------
+// ----------------------------------TaskGroup Members---------------------------------
+// ------------------------------------------------------------------------------------
+
+TaskGroup::TaskGroup()
+: Pending(0), Completing(0), ContinuationGroup(NULL)
+{
+}
+
+
+// ------------------------------------------------------------------------------------
+// ----------------------------------JobSystem Members---------------------------------
+// ------------------------------------------------------------------------------------
+
+JobSystem::JobSystem()
+: QueuedTasks(0), Stopping(false)
+{
+    // Deque for the owning thread, so tasks can be run before Start()
+    Queues.push_back( new WorkerQueue );
+}
+
+JobSystem::~JobSystem()
+{
+    Stop();
+
+    for (unsigned int i = 0; i < Queues.size(); i++)
+        delete Queues[i];
+}
+
+void JobSystem::Start( int NumWorkers, bool PinWorkers )
+{
+    Stop();
+
+    if (NumWorkers <= 0)
+        NumWorkers = static_cast<int>(thread::hardware_concurrency()) - 1;
+
+    // The starting thread owns deque 0
+    CurrentSystem = this;
+    CurrentQueue = 0;
+    if (PinWorkers)
+        PinCurrentThread( 0 );
+
+    Stopping = false;
+    for (int i = 1; i <= NumWorkers; i++)
+        Queues.push_back( new WorkerQueue );
+
+    for (int i = 1; i <= NumWorkers; i++)
+        Workers.push_back( thread( &JobSystem::WorkerLoop, this, i, PinWorkers ) );
+}
+
+void JobSystem::Stop()
+{
+    if (Workers.empty())
+        return;
+
+    // Wake every worker so it sees the stop flag
+    {
+        lock_guard<mutex> Lock( SleepLock );
+        Stopping = true;
+    }
+    SleepCondition.notify_all();
+
+    for (unsigned int i = 0; i < Workers.size(); i++)
+        Workers[i].join();
+    Workers.clear();
+
+    // Tasks left in worker deques move to the owner's deque so they still run on Wait()
+    for (unsigned int i = 1; i < Queues.size(); i++)
+    {
+        for (; !Queues[i]->Tasks.empty(); Queues[i]->Tasks.pop_front())
+            Queues[0]->Tasks.push_back( Queues[i]->Tasks.front() );
+
+        delete Queues[i];
+    }
+    Queues.resize( 1 );
+}
+
+void JobSystem::Run( TaskGroup &Group, const TaskFunction &Function )
+{
+    Group.Pending.fetch_add( 1, memory_order_relaxed );
+
+    Task NewTask;
+    NewTask.Function = Function;
+    NewTask.Group = &Group;
+    Push( NewTask );
+}
+
+void JobSystem::Then( TaskGroup &Group, const TaskFunction &Continuation, TaskGroup &NextGroup )
+{
+    // NextGroup counts the continuation from now on, so waiting on it also waits on Group
+    NextGroup.Pending.fetch_add( 1, memory_order_relaxed );
+
+    {
+        lock_guard<mutex> Lock( Group.ContinuationLock );
+        if (Group.Pending.load( memory_order_acquire ) > 0)
+        {
+            Group.Continuation = Continuation;
+            Group.ContinuationGroup = &NextGroup;
+            return;
+        }
+    }
+
+    // Group already finished
+    Task NewTask;
+    NewTask.Function = Continuation;
+    NewTask.Group = &NextGroup;
+    Push( NewTask );
+}
+
+void JobSystem::Wait( TaskGroup &Group )
+{
+    while (!Group.IsDone())
+    {
+        Task Found;
+        if (FindTask( Found ))
+            Execute( Found );
+        else
+            this_thread::yield();
+    }
+}
+
+void JobSystem::Push( const Task &NewTask )
+{
+    int Index = CurrentSystem == this ? CurrentQueue : 0;
+
+    {
+        lock_guard<mutex> Lock( Queues[Index]->Lock );
+        Queues[Index]->Tasks.push_back( NewTask );
+    }
+
+    QueuedTasks.fetch_add( 1, memory_order_release );
+
+    // Taking the lock orders the notify after a worker's predicate check, so none are missed
+    {
+        lock_guard<mutex> Lock( SleepLock );
+    }
+    SleepCondition.notify_one();
+}
+
+bool JobSystem::FindTask( Task &Found )
+{
+    int Own = CurrentSystem == this ? CurrentQueue : 0;
+    int NumQueues = static_cast<int>(Queues.size());
+
+    // Newest task from our own deque first, it is the most likely to be in cache
+    {
+        WorkerQueue &Queue = *Queues[Own];
+        lock_guard<mutex> Lock( Queue.Lock );
+        if (!Queue.Tasks.empty())
+        {
+            Found = Queue.Tasks.back();
+            Queue.Tasks.pop_back();
+            QueuedTasks.fetch_sub( 1, memory_order_relaxed );
+            return true;
+        }
+    }
+
+    // Then steal the oldest task of another deque
+    for (int i = 1; i < NumQueues; i++)
+    {
+        WorkerQueue &Victim = *Queues[(Own + i) % NumQueues];
+        lock_guard<mutex> Lock( Victim.Lock );
+        if (!Victim.Tasks.empty())
+        {
+            Found = Victim.Tasks.front();
+            Victim.Tasks.pop_front();
+            QueuedTasks.fetch_sub( 1, memory_order_relaxed );
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void JobSystem::Execute( Task &ToRun )
+{
+    ToRun.Function();
+    Complete( *ToRun.Group );
+}
+
+void JobSystem::Complete( TaskGroup &Group )
+{
+    // Keep waiters out until we are done with the group, see TaskGroup::Completing
+    Group.Completing.fetch_add( 1 );
+
+    if (Group.Pending.fetch_sub( 1 ) != 1)
+    {
+        Group.Completing.fetch_sub( 1 );
+        return;
+    }
+
+    // Last task of the group, hand over to the continuation if one is registered
+    Task NewTask;
+    {
+        lock_guard<mutex> Lock( Group.ContinuationLock );
+        NewTask.Function.swap( Group.Continuation );
+        NewTask.Group = Group.ContinuationGroup;
+        Group.ContinuationGroup = NULL;
+    }
+
+    Group.Completing.fetch_sub( 1 );
+
+    if (NewTask.Function)
+        Push( NewTask );
+}
+
+void JobSystem::WorkerLoop( int Index, bool Pin )
+{
+    CurrentSystem = this;
+    CurrentQueue = Index;
+
+    if (Pin)
+        PinCurrentThread( Index );
+
+    while (!Stopping.load( memory_order_acquire ))
+    {
+        Task Found;
+        if (FindTask( Found ))
+        {
+            Execute( Found );
+            continue;
+        }
+
+        unique_lock<mutex> Lock( SleepLock );
+        while (QueuedTasks.load( memory_order_acquire ) == 0 && !Stopping.load( memory_order_acquire ))
+            SleepCondition.wait( Lock );
+    }
+}
+
+void JobSystem::PinCurrentThread( int HardwareThread )
+{
+    int NumHardwareThreads = static_cast<int>(thread::hardware_concurrency());
+    if (NumHardwareThreads <= 0)
+        return;
+
+    HardwareThread %= NumHardwareThreads;
+
+#if defined(_WIN32)
+    SetThreadAffinityMask( GetCurrentThread(), static_cast<DWORD_PTR>(1) << HardwareThread );
+#elif defined(__linux__)
+    cpu_set_t Set;
+    CPU_ZERO( &Set );
+    CPU_SET( HardwareThread, &Set );
+    pthread_setaffinity_np( pthread_self(), sizeof(Set), &Set );
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,175 @@
+#ifndef JOBSYSTEM_H
+#define JOBSYSTEM_H
+
+
+
+// ------------------------------------------------------------------------------------
+// ----------------------------------Included headers----------------------------------
+// ------------------------------------------------------------------------------------
+
+// C++ standard library & STL
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+// ------------------------------------------------------------------------------------
+// ---------------------------------------Classes--------------------------------------
+// ------------------------------------------------------------------------------------
+
+// Tracks a set of tasks so they can be waited on, or followed by a continuation
+class TaskGroup
+{
+public:
+    TaskGroup();
+
+    // True once every task run in the group (and its continuation, if any) has finished
+    inline bool IsDone() const;
+
+private:
+    friend class JobSystem;
+
+    std::atomic<int> Pending;
+
+    // Threads still completing a task of the group. The group may be destroyed as soon as it
+    // is done, so a completing thread must not touch it after it decrements this.
+    std::atomic<int> Completing;
+
+    // Task spawned into ContinuationGroup once Pending drops to zero
+    std::mutex ContinuationLock;
+    std::function<void()> Continuation;
+    TaskGroup *ContinuationGroup;
+
+    // Disable copying, tasks refer to their group by address
+    TaskGroup( const TaskGroup & );
+    TaskGroup &operator = ( const TaskGroup & );
+};
+
+// Work-stealing thread pool.
+// Every worker owns a deque: it pushes and pops its own tasks at the back, and idle workers
+// steal from the front of other deques. The thread that calls Start() owns deque 0 and
+// helps run tasks while it waits, other threads submit to deque 0 as well.
+class JobSystem
+{
+public:
+    typedef std::function<void()> TaskFunction;
+
+    JobSystem();
+    ~JobSystem();
+
+    // Start NumWorkers worker threads, 0 uses one per hardware thread less the caller.
+    // Pinned workers are bound to one hardware thread each, starting after the caller's.
+    void Start( int NumWorkers = 0, bool PinWorkers = false );
+    void Stop();
+
+    // Accessors
+    inline int GetNumWorkers() const;
+
+    // Run Task asynchronously as part of Group
+    void Run( TaskGroup &Group, const TaskFunction &Task );
+
+    // Run Continuation as part of NextGroup once every task in Group has finished
+    void Then( TaskGroup &Group, const TaskFunction &Continuation, TaskGroup &NextGroup );
+
+    // Block until every task in Group has finished, running queued tasks meanwhile
+    void Wait( TaskGroup &Group );
+
+    // Call Body( RangeBegin, RangeEnd ) over [Begin, End) in chunks of at most GrainSize
+    // indices, spread across the workers. Returns once every chunk has run.
+    template <typename Function>
+    void ParallelFor( int Begin, int End, int GrainSize, const Function &Body );
+
+private:
+    struct Task
+    {
+        TaskFunction Function;
+        TaskGroup *Group;
+    };
+
+    struct WorkerQueue
+    {
+        std::mutex Lock;
+        std::deque<Task> Tasks;
+    };
+
+    std::vector<WorkerQueue *> Queues;
+    std::vector<std::thread> Workers;
+
+    // Sleeping workers wait for QueuedTasks to become non-zero
+    std::atomic<int> QueuedTasks;
+    std::atomic<bool> Stopping;
+    std::mutex SleepLock;
+    std::condition_variable SleepCondition;
+
+
+    // Queue a task on the calling thread's deque
+    void Push( const Task &NewTask );
+    // Pop from the calling thread's deque, or steal from another
+    bool FindTask( Task &Found );
+    // Run a task and complete it in its group
+    void Execute( Task &ToRun );
+    void Complete( TaskGroup &Group );
+
+    void WorkerLoop( int Index, bool Pin );
+
+    // Bind the calling thread to a hardware thread
+    static void PinCurrentThread( int HardwareThread );
+
+    // Disable copying
+    JobSystem( const JobSystem & );
+    JobSystem &operator = ( const JobSystem & );
+};
+
+
+// ------------------------------------------------------------------------------------
+// -----------------------------Inline function definitions----------------------------
+// ------------------------------------------------------------------------------------
+
+bool TaskGroup::IsDone() const
+{
+    return Pending.load() == 0 && Completing.load() == 0;
+}
+
+int JobSystem::GetNumWorkers() const
+{
+    return static_cast<int>(Workers.size());
+}
+
+
+// ------------------------------------------------------------------------------------
+// ---------------------------Templatized member definitions---------------------------
+// ------------------------------------------------------------------------------------
+
+template <typename Function>
+void JobSystem::ParallelFor( int Begin, int End, int GrainSize, const Function &Body )
+{
+    if (End <= Begin)
+        return;
+
+    if (GrainSize < 1)
+        GrainSize = 1;
+
+    // Run small ranges, or everything when there are no workers, inline
+    if (Workers.empty() || End - Begin <= GrainSize)
+    {
+        Body( Begin, End );
+        return;
+    }
+
+    TaskGroup Group;
+    for (int ChunkBegin = Begin; ChunkBegin < End; ChunkBegin += GrainSize)
+    {
+        int ChunkEnd = End - ChunkBegin > GrainSize ? ChunkBegin + GrainSize : End;
+        Run( Group, [&Body, ChunkBegin, ChunkEnd]() { Body( ChunkBegin, ChunkEnd ); } );
+    }
+
+    Wait( Group );
+}
+
+
+
+#endif
\ No newline at end of file
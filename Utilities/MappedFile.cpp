@@ -0,0 +1,144 @@
+// ------------------------------------------------------------------------------------
+// ----------------------------------Included headers----------------------------------
+// ------------------------------------------------------------------------------------
+#include "MappedFile.h"
+
+#if defined(_WIN32)
+// Windows
+#include <Windows.h>
+#else
+// POSIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+// Utilities
+#include "Exceptions.h"
+
+
+// ------------------------------------------------------------------------------------
+// ---------------------------------MappedFile Members---------------------------------
+// ------------------------------------------------------------------------------------
+
+MappedFile::MappedFile()
+: Data(NULL), Size(0), Opened(false)
+{
+#if defined(_WIN32)
+    FileHandle = INVALID_HANDLE_VALUE;
+    MappingHandle = NULL;
+#endif
+}
+
+MappedFile::MappedFile( const char *FilePath )
+: Data(NULL), Size(0), Opened(false)
+{
+#if defined(_WIN32)
+    FileHandle = INVALID_HANDLE_VALUE;
+    MappingHandle = NULL;
+#endif
+
+    Open( FilePath );
+}
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+void MappedFile::Open( const char *FilePath )
+{
+    Close();
+
+#if defined(_WIN32)
+    FileHandle = CreateFileA( FilePath, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL );
+    if (FileHandle == INVALID_HANDLE_VALUE)
+        throw FileNotFoundException( FilePath );
+
+    LARGE_INTEGER FileSize;
+    if (!GetFileSizeEx( FileHandle, &FileSize ))
+    {
+        Close();
+        throw FileIOException( FilePath, "Failed to get file size." );
+    }
+    Size = static_cast<size_t>(FileSize.QuadPart);
+    Opened = true;
+
+    // Empty files can't be mapped
+    if (Size == 0)
+        return;
+
+    MappingHandle = CreateFileMappingA( FileHandle, NULL, PAGE_READONLY, 0, 0, NULL );
+    if (MappingHandle == NULL)
+    {
+        Close();
+        throw FileIOException( FilePath, "Failed to map file." );
+    }
+
+    Data = static_cast<const char *>(MapViewOfFile( MappingHandle, FILE_MAP_READ, 0, 0, 0 ));
+    if (Data == NULL)
+    {
+        Close();
+        throw FileIOException( FilePath, "Failed to map file." );
+    }
+#else
+    int File = open( FilePath, O_RDONLY );
+    if (File < 0)
+    {
+        if (errno == ENOENT)
+            throw FileNotFoundException( FilePath );
+        throw FileIOException( FilePath, "Failed to open file." );
+    }
+
+    struct stat Status;
+    if (fstat( File, &Status ) != 0)
+    {
+        close( File );
+        throw FileIOException( FilePath, "Failed to get file size." );
+    }
+    Size = static_cast<size_t>(Status.st_size);
+    Opened = true;
+
+    // Empty files can't be mapped. The mapping keeps the file referenced, so it can be closed.
+    if (Size > 0)
+    {
+        void *View = mmap( NULL, Size, PROT_READ, MAP_PRIVATE, File, 0 );
+        if (View == MAP_FAILED)
+        {
+            close( File );
+            Size = 0;
+            Opened = false;
+            throw FileIOException( FilePath, "Failed to map file." );
+        }
+
+        Data = static_cast<const char *>(View);
+    }
+
+    close( File );
+#endif
+}
+
+void MappedFile::Close()
+{
+#if defined(_WIN32)
+    if (Data != NULL)
+        UnmapViewOfFile( Data );
+    if (MappingHandle != NULL)
+        CloseHandle( MappingHandle );
+    if (FileHandle != INVALID_HANDLE_VALUE)
+        CloseHandle( FileHandle );
+
+    FileHandle = INVALID_HANDLE_VALUE;
+    MappingHandle = NULL;
+#else
+    if (Data != NULL)
+        munmap( const_cast<char *>(Data), Size );
+#endif
+
+    Data = NULL;
+    Size = 0;
+    Opened = false;
+}
\ No newline at end of file
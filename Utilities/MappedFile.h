@@ -0,0 +1,75 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+
+
+// ------------------------------------------------------------------------------------
+// ----------------------------------Included headers----------------------------------
+// ------------------------------------------------------------------------------------
+
+// C++ standard library & STL
+#include <cstddef>
+
+
+// ------------------------------------------------------------------------------------
+// ---------------------------------------Classes--------------------------------------
+// ------------------------------------------------------------------------------------
+
+// Read-only view of a whole file, mapped into memory rather than read through a stream.
+// The view is valid until Close() or destruction. Empty files open with a NULL view.
+class MappedFile
+{
+public:
+    MappedFile();
+    // May throw: FileIOException, FileNotFoundException
+    MappedFile( const char *FilePath );
+    ~MappedFile();
+
+    // Map FilePath, closing any file mapped before
+    // - May throw: FileIOException, FileNotFoundException
+    void Open( const char *FilePath );
+    void Close();
+
+    // Accessors
+    inline const char *GetData() const;
+    inline size_t GetSize() const;
+    inline bool IsOpen() const;
+
+private:
+    const char *Data;
+    size_t Size;
+    bool Opened;
+
+#if defined(_WIN32)
+    // File and mapping HANDLEs
+    void *FileHandle, *MappingHandle;
+#endif
+
+    // Disable copying
+    MappedFile( const MappedFile & );
+    MappedFile &operator = ( const MappedFile & );
+};
+
+
+// ------------------------------------------------------------------------------------
+// -----------------------------Inline function definitions----------------------------
+// ------------------------------------------------------------------------------------
+
+const char *MappedFile::GetData() const
+{
+    return Data;
+}
+
+size_t MappedFile::GetSize() const
+{
+    return Size;
+}
+
+bool MappedFile::IsOpen() const
+{
+    return Opened;
+}
+
+
+
+#endif
\ No newline at end of file
@@ -0,0 +1,64 @@
+// ------------------------------------------------------------------------------------
+// ----------------------------------Included headers----------------------------------
+// ------------------------------------------------------------------------------------
+#include "MemoryStats.h"
+
+#if defined(_WIN32)
+// Windows
+#include <Windows.h>
+#include <Psapi.h>
+#pragma comment( lib, "psapi.lib" )
+#else
+// POSIX
+#include <cstdio>
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+
+// ------------------------------------------------------------------------------------
+// --------------------------------Function definitions--------------------------------
+// ------------------------------------------------------------------------------------
+
+unsigned long long GetResidentBytes()
+{
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS Counters;
+    if (!GetProcessMemoryInfo( GetCurrentProcess(), &Counters, sizeof(Counters) ))
+        return 0;
+
+    return Counters.WorkingSetSize;
+#else
+    // Second field of statm is the resident page count
+    FILE *File = fopen( "/proc/self/statm", "r" );
+    if (File == NULL)
+        return 0;
+
+    unsigned long long Size = 0, Resident = 0;
+    int Read = fscanf( File, "%llu %llu", &Size, &Resident );
+    fclose( File );
+
+    if (Read != 2)
+        return 0;
+
+    return Resident * static_cast<unsigned long long>(sysconf( _SC_PAGESIZE ));
+#endif
+}
+
+unsigned long long GetPeakResidentBytes()
+{
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS Counters;
+    if (!GetProcessMemoryInfo( GetCurrentProcess(), &Counters, sizeof(Counters) ))
+        return 0;
+
+    return Counters.PeakWorkingSetSize;
+#else
+    rusage Usage;
+    if (getrusage( RUSAGE_SELF, &Usage ) != 0)
+        return 0;
+
+    // Linux reports kilobytes
+    return static_cast<unsigned long long>(Usage.ru_maxrss) * 1024;
+#endif
+}
\ No newline at end of file
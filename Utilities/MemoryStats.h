@@ -0,0 +1,19 @@
+#ifndef MEMORYSTATS_H
+#define MEMORYSTATS_H
+
+
+
+// ------------------------------------------------------------------------------------
+// ---------------------------------Function prototypes--------------------------------
+// ------------------------------------------------------------------------------------
+
+// Resident set size (working set on Windows) of the process in bytes, 0 if unknown.
+// Costs a system call, sample it rather than calling it every tick.
+unsigned long long GetResidentBytes();
+
+// Peak resident set size of the process in bytes, 0 if unknown
+unsigned long long GetPeakResidentBytes();
+
+
+
+#endif
\ No newline at end of file
@@ -0,0 +1,164 @@
+#ifndef OBJECTPOOL_H
+#define OBJECTPOOL_H
+
+
+
+// ------------------------------------------------------------------------------------
+// ----------------------------------Included headers----------------------------------
+// ------------------------------------------------------------------------------------
+
+// C++ standard library & STL
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+#include <type_traits>
+
+
+// ------------------------------------------------------------------------------------
+// --------------------Templatized class declarations & definitions--------------------
+// ------------------------------------------------------------------------------------
+
+// Slab allocator for objects of a single type.
+// Objects are carved out of contiguous chunks of ObjectsPerChunk slots. Freed slots go on
+// an intrusive free list, so New() and Delete() are O(1) and never touch the system
+// allocator once enough chunks exist. Chunks are only returned by FreeMemory() or
+// destruction, so a pool that outlives its users lets the next user reuse the memory.
+template <typename T>
+class ObjectPool
+{
+public:
+    ObjectPool( unsigned int ObjectsPerChunk = 256 )
+    : ObjectsPerChunk(ObjectsPerChunk), FreeList(NULL), CurrentChunk(0), NextSlot(0), LiveCount(0)
+    {
+    }
+
+    ~ObjectPool()
+    {
+        FreeMemory();
+    }
+
+    // Construct an object in a free slot
+    template <typename... ArgTypes>
+    T *New( ArgTypes &&... Arguments )
+    {
+        return new (AllocateSlot()) T( std::forward<ArgTypes>( Arguments )... );
+    }
+
+    // Destroy an object and return its slot to the pool
+    void Delete( T *Object )
+    {
+        if (Object == NULL)
+            return;
+
+        Object->~T();
+
+        Slot *Freed = reinterpret_cast<Slot *>(Object);
+        Freed->Next = FreeList;
+        FreeList = Freed;
+        LiveCount--;
+    }
+
+    // Discard every object at once, keeping the chunks for reuse. Destructors are not run,
+    // so this is only available for trivially destructible types.
+    void ReleaseAll()
+    {
+        static_assert( std::is_trivially_destructible<T>::value, "ObjectPool::ReleaseAll() would skip destructors" );
+
+        FreeList = NULL;
+        CurrentChunk = 0;
+        NextSlot = 0;
+        LiveCount = 0;
+    }
+
+    // Return all chunks to the system. Every object must have been deleted or released.
+    void FreeMemory()
+    {
+        for (unsigned int i = 0; i < Chunks.size(); i++)
+            ::operator delete( Chunks[i] );
+
+        Chunks.clear();
+        FreeList = NULL;
+        CurrentChunk = 0;
+        NextSlot = 0;
+        LiveCount = 0;
+    }
+
+    // Accessors
+    unsigned int GetLiveCount() const
+    {
+        return LiveCount;
+    }
+
+    unsigned int GetCapacity() const
+    {
+        return static_cast<unsigned int>(Chunks.size()) * ObjectsPerChunk;
+    }
+
+    unsigned int GetChunkCount() const
+    {
+        return static_cast<unsigned int>(Chunks.size());
+    }
+
+    size_t GetReservedBytes() const
+    {
+        return Chunks.size() * ObjectsPerChunk * sizeof(Slot);
+    }
+
+    // Space each object takes, at least a pointer for the free list link
+    static size_t GetSlotBytes()
+    {
+        return sizeof(Slot);
+    }
+
+private:
+    // A free slot holds the free list link, a used one the object
+    union Slot
+    {
+        Slot *Next;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type Storage;
+    };
+
+    unsigned int ObjectsPerChunk;
+    std::vector<Slot *> Chunks;
+
+    // Recently freed slots, reused first since they are likely still in cache
+    Slot *FreeList;
+
+    // Next never used slot, chunks are filled in order
+    unsigned int CurrentChunk, NextSlot;
+
+    unsigned int LiveCount;
+
+
+    void *AllocateSlot()
+    {
+        LiveCount++;
+
+        if (FreeList != NULL)
+        {
+            Slot *Allocated = FreeList;
+            FreeList = FreeList->Next;
+            return Allocated;
+        }
+
+        if (NextSlot == ObjectsPerChunk)
+        {
+            CurrentChunk++;
+            NextSlot = 0;
+        }
+
+        if (CurrentChunk == Chunks.size())
+            Chunks.push_back( static_cast<Slot *>(::operator new( ObjectsPerChunk * sizeof(Slot) )) );
+
+        return &Chunks[CurrentChunk][NextSlot++];
+    }
+
+    // Disable copying
+    ObjectPool( const ObjectPool & );
+    ObjectPool &operator = ( const ObjectPool & );
+};
+
+
+
+#endif
\ No newline at end of file
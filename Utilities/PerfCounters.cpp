@@ -0,0 +1,199 @@
+// ------------------------------------------------------------------------------------
+// ----------------------------------Included headers----------------------------------
+// ------------------------------------------------------------------------------------
+#include "PerfCounters.h"
+
+// C standard library
+#include <cerrno>
+#include <cstring>
+
+// C++ standard library
+#include <string>
+using namespace std;
+
+// Linux performance events
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+
+// ------------------------------------------------------------------------------------
+// -------------------------------PerfCounterValues Members----------------------------
+// ------------------------------------------------------------------------------------
+
+PerfCounterValues::PerfCounterValues()
+{
+    Clear();
+}
+
+void PerfCounterValues::Clear()
+{
+    for (int i = 0; i < PERF_NUM_EVENTS; i++)
+        Values[i] = 0;
+}
+
+PerfCounterValues &PerfCounterValues::operator += (const PerfCounterValues &rhs)
+{
+    for (int i = 0; i < PERF_NUM_EVENTS; i++)
+        Values[i] += rhs.Values[i];
+
+    return *this;
+}
+
+PerfCounterValues PerfCounterValues::operator - (const PerfCounterValues &rhs) const
+{
+    PerfCounterValues Result;
+    for (int i = 0; i < PERF_NUM_EVENTS; i++)
+        Result.Values[i] = Values[i] - rhs.Values[i];
+
+    return Result;
+}
+
+
+// ------------------------------------------------------------------------------------
+// -------------------------------PerfCounterGroup Members-----------------------------
+// ------------------------------------------------------------------------------------
+
+#if defined(__linux__)
+// Open a single counter for the calling thread on any CPU, GroupFD of -1 creates a leader
+static int OpenPerfEvent( unsigned int Type, unsigned long long Config, int GroupFD )
+{
+    perf_event_attr Attr;
+    memset( &Attr, 0, sizeof(Attr) );
+    Attr.size = sizeof(Attr);
+    Attr.type = Type;
+    Attr.config = Config;
+    Attr.disabled = GroupFD == -1 ? 1 : 0;
+    Attr.exclude_kernel = 1;
+    Attr.exclude_hv = 1;
+    Attr.read_format = PERF_FORMAT_GROUP;
+
+    return static_cast<int>(syscall( __NR_perf_event_open, &Attr, 0, -1, GroupFD, 0 ));
+}
+#endif
+
+PerfCounterGroup::PerfCounterGroup()
+: LeaderFD(-1), NumOpened(0), Status("Not opened")
+{
+    for (int i = 0; i < PERF_NUM_EVENTS; i++)
+    {
+        EventFD[i] = -1;
+        ReadIndex[i] = -1;
+    }
+}
+
+PerfCounterGroup::~PerfCounterGroup()
+{
+    Close();
+}
+
+bool PerfCounterGroup::Open()
+{
+    Close();
+
+#if defined(__linux__)
+    const unsigned int Types[PERF_NUM_EVENTS] =
+    {
+        PERF_TYPE_HARDWARE,
+        PERF_TYPE_HARDWARE,
+        PERF_TYPE_HW_CACHE,
+        PERF_TYPE_HARDWARE,
+        PERF_TYPE_HARDWARE
+    };
+    const unsigned long long Configs[PERF_NUM_EVENTS] =
+    {
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+        PERF_COUNT_HW_CACHE_MISSES,
+        PERF_COUNT_HW_BRANCH_MISSES
+    };
+
+    // Cycles lead the group, every other event is optional and simply reads as zero if missing
+    for (int i = 0; i < PERF_NUM_EVENTS; i++)
+    {
+        EventFD[i] = OpenPerfEvent( Types[i], Configs[i], LeaderFD );
+        if (EventFD[i] == -1)
+        {
+            if (i == PERF_CYCLES)
+            {
+                Status = string() + "perf_event_open failed: " + strerror( errno );
+                return false;
+            }
+            continue;
+        }
+
+        if (LeaderFD == -1)
+            LeaderFD = EventFD[i];
+
+        ReadIndex[i] = NumOpened++;
+    }
+
+    ioctl( LeaderFD, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP );
+    ioctl( LeaderFD, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP );
+
+    Status = NumOpened == PERF_NUM_EVENTS ? "All counters available" : "Some counters unavailable";
+    return true;
+#else
+    Status = "Hardware counters are only supported on Linux";
+    return false;
+#endif
+}
+
+void PerfCounterGroup::Close()
+{
+#if defined(__linux__)
+    for (int i = 0; i < PERF_NUM_EVENTS; i++)
+    {
+        if (EventFD[i] != -1)
+            close( EventFD[i] );
+    }
+#endif
+
+    for (int i = 0; i < PERF_NUM_EVENTS; i++)
+    {
+        EventFD[i] = -1;
+        ReadIndex[i] = -1;
+    }
+
+    LeaderFD = -1;
+    NumOpened = 0;
+}
+
+void PerfCounterGroup::Read( PerfCounterValues &Values ) const
+{
+    Values.Clear();
+
+#if defined(__linux__)
+    if (LeaderFD == -1)
+        return;
+
+    // Group read layout is the number of counters followed by one value per counter
+    unsigned long long Buffer[PERF_NUM_EVENTS + 1];
+    if (read( LeaderFD, Buffer, sizeof(Buffer) ) < static_cast<ssize_t>(sizeof(unsigned long long)))
+        return;
+
+    for (int i = 0; i < PERF_NUM_EVENTS; i++)
+    {
+        if (ReadIndex[i] >= 0 && static_cast<unsigned long long>(ReadIndex[i]) < Buffer[0])
+            Values.Values[i] = Buffer[ReadIndex[i] + 1];
+    }
+#endif
+}
+
+const char *PerfCounterGroup::GetEventName( PerfCounterEvent Event )
+{
+    static const char *Names[PERF_NUM_EVENTS] =
+    {
+        "Cycles",
+        "Instructions",
+        "L1D misses",
+        "LLC misses",
+        "Branch misses"
+    };
+
+    return Names[Event];
+}
\ No newline at end of file
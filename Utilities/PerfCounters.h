@@ -0,0 +1,110 @@
+#ifndef PERFCOUNTERS_H
+#define PERFCOUNTERS_H
+
+
+
+// ------------------------------------------------------------------------------------
+// ----------------------------------Included headers----------------------------------
+// ------------------------------------------------------------------------------------
+
+// C++ standard library
+#include <string>
+
+
+// ------------------------------------------------------------------------------------
+// --------------------------------------Structures------------------------------------
+// ------------------------------------------------------------------------------------
+
+// Hardware events sampled by PerfCounterGroup
+enum PerfCounterEvent
+{
+    PERF_CYCLES = 0,
+    PERF_INSTRUCTIONS,
+    PERF_L1D_MISSES,
+    PERF_LLC_MISSES,
+    PERF_BRANCH_MISSES,
+
+    PERF_NUM_EVENTS
+};
+
+// A snapshot (or difference of snapshots) of all hardware counters
+struct PerfCounterValues
+{
+    PerfCounterValues();
+
+    void Clear();
+
+    PerfCounterValues &operator += (const PerfCounterValues &rhs);
+    PerfCounterValues operator - (const PerfCounterValues &rhs) const;
+
+    unsigned long long Values[PERF_NUM_EVENTS];
+};
+
+
+// ------------------------------------------------------------------------------------
+// ---------------------------------------Classes--------------------------------------
+// ------------------------------------------------------------------------------------
+
+// Group of free-running hardware performance counters for the calling thread.
+// Uses perf_event_open on Linux. Where the counters cannot be opened (other platforms,
+// kernel.perf_event_paranoid, virtual machines without a PMU) the group reports itself
+// unavailable and Read() returns zeros, so callers never need to special-case it.
+class PerfCounterGroup
+{
+public:
+    PerfCounterGroup();
+    ~PerfCounterGroup();
+
+    // Opens the counters, returns false if none of them could be opened
+    bool Open();
+    void Close();
+
+    // Accessors
+    inline bool IsAvailable() const;
+    inline bool IsEventAvailable( PerfCounterEvent Event ) const;
+    inline const std::string &GetStatus() const;
+
+    // Read current counter values, events that failed to open read as zero
+    void Read( PerfCounterValues &Values ) const;
+
+    // Human readable name of an event
+    static const char *GetEventName( PerfCounterEvent Event );
+
+private:
+    int LeaderFD;
+    int EventFD[PERF_NUM_EVENTS];
+
+    // Position of each event within a group read, -1 if the event is not in the group
+    int ReadIndex[PERF_NUM_EVENTS];
+    int NumOpened;
+
+    std::string Status;
+
+    // Disable copying, the group owns file descriptors
+    PerfCounterGroup( const PerfCounterGroup & );
+    PerfCounterGroup &operator = ( const PerfCounterGroup & );
+};
+
+
+// ------------------------------------------------------------------------------------
+// -----------------------------Inline function definitions----------------------------
+// ------------------------------------------------------------------------------------
+
+bool PerfCounterGroup::IsAvailable() const
+{
+    return NumOpened > 0;
+}
+
+bool PerfCounterGroup::IsEventAvailable( PerfCounterEvent Event ) const
+{
+    return ReadIndex[Event] >= 0;
+}
+
+const std::string &PerfCounterGroup::GetStatus() const
+{
+    return Status;
+}
+
+
+
+#endif
\ No newline at end of file
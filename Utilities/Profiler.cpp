@@ -0,0 +1,273 @@
+// ------------------------------------------------------------------------------------
+// ----------------------------------Included headers----------------------------------
+// ------------------------------------------------------------------------------------
+#include "Profiler.h"
+
+// C++ standard library & STL
+#include <string>
+#include <vector>
+#include <ostream>
+#include <iomanip>
+#include <chrono>
+using namespace std;
+
+// Utilities
+#include "PerfCounters.h"
+
+
+// ------------------------------------------------------------------------------------
+// -------------------------------ProfileZoneStats Members-----------------------------
+// ------------------------------------------------------------------------------------
+
+ProfileZoneStats::ProfileZoneStats( const string &Name )
+: Name(Name), Calls(0), TotalSeconds(0), MaxSeconds(0), FrameSeconds(0), LastFrameSeconds(0),
+  Units(0), SampleCounters(false)
+{
+}
+
+
+// ------------------------------------------------------------------------------------
+// --------------------------------ProfileCounter Members------------------------------
+// ------------------------------------------------------------------------------------
+
+ProfileCounter::ProfileCounter( const string &Name )
+: Name(Name), Value(0), LastFrameValue(0)
+{
+}
+
+
+// ------------------------------------------------------------------------------------
+// -----------------------------------Profiler Members---------------------------------
+// ------------------------------------------------------------------------------------
+
+Profiler::Profiler()
+: CounterAllZones(false)
+{
+}
+
+int Profiler::RegisterZone( const char *Name )
+{
+    int ID = FindZone( Name );
+    if (ID >= 0)
+        return ID;
+
+    Zones.push_back( ProfileZoneStats( Name ) );
+
+    // Zones registered after EnableCounters() still pick up the requested sampling
+    ProfileZoneStats &Zone = Zones.back();
+    Zone.SampleCounters = Counters.IsAvailable() && CounterAllZones;
+    for (unsigned int i = 0; i < CounterZoneNames.size(); i++)
+    {
+        if (Counters.IsAvailable() && CounterZoneNames[i] == Name)
+            Zone.SampleCounters = true;
+    }
+
+    return static_cast<int>(Zones.size()) - 1;
+}
+
+int Profiler::RegisterCounter( const char *Name )
+{
+    int ID = FindCounter( Name );
+    if (ID >= 0)
+        return ID;
+
+    FrameCounters.push_back( ProfileCounter( Name ) );
+
+    return static_cast<int>(FrameCounters.size()) - 1;
+}
+
+int Profiler::FindZone( const char *Name ) const
+{
+    for (unsigned int i = 0; i < Zones.size(); i++)
+    {
+        if (Zones[i].Name == Name)
+            return i;
+    }
+
+    return -1;
+}
+
+int Profiler::FindCounter( const char *Name ) const
+{
+    for (unsigned int i = 0; i < FrameCounters.size(); i++)
+    {
+        if (FrameCounters[i].Name == Name)
+            return i;
+    }
+
+    return -1;
+}
+
+bool Profiler::EnableCounters( const string &ZoneNames )
+{
+    // Split comma separated zone list
+    CounterZoneNames.clear();
+    string::size_type Start = 0;
+    while (Start <= ZoneNames.length())
+    {
+        string::size_type End = ZoneNames.find( ',', Start );
+        if (End == string::npos)
+            End = ZoneNames.length();
+
+        if (End > Start)
+            CounterZoneNames.push_back( ZoneNames.substr( Start, End - Start ) );
+
+        Start = End + 1;
+    }
+
+    CounterAllZones = ZoneNames == "*";
+
+    if (!Counters.IsAvailable() && !Counters.Open())
+        return false;
+
+    for (unsigned int i = 0; i < Zones.size(); i++)
+    {
+        Zones[i].SampleCounters = CounterAllZones;
+        for (unsigned int j = 0; j < CounterZoneNames.size(); j++)
+        {
+            if (CounterZoneNames[j] == Zones[i].Name)
+                Zones[i].SampleCounters = true;
+        }
+    }
+
+    return true;
+}
+
+void Profiler::BeginZone( int ZoneID, ProfileSample &Sample )
+{
+    if (Zones[ZoneID].SampleCounters)
+        Counters.Read( Sample.StartCounters );
+
+    // Read the clock last so counter reads are not included in the zone time
+    Sample.StartTicks = GetTicks();
+}
+
+void Profiler::EndZone( int ZoneID, const ProfileSample &Sample )
+{
+    long long EndTicks = GetTicks();
+
+    ProfileZoneStats &Zone = Zones[ZoneID];
+    if (Zone.SampleCounters)
+    {
+        PerfCounterValues EndCounters;
+        Counters.Read( EndCounters );
+        Zone.Counters += EndCounters - Sample.StartCounters;
+    }
+
+    double Seconds = (EndTicks - Sample.StartTicks) * GetSecondsPerTick();
+    Zone.TotalSeconds += Seconds;
+    Zone.FrameSeconds += Seconds;
+    if (Seconds > Zone.MaxSeconds)
+        Zone.MaxSeconds = Seconds;
+
+    Zone.Calls++;
+}
+
+void Profiler::EndFrame()
+{
+    for (unsigned int i = 0; i < Zones.size(); i++)
+    {
+        Zones[i].LastFrameSeconds = Zones[i].FrameSeconds;
+        Zones[i].FrameSeconds = 0;
+    }
+
+    for (unsigned int i = 0; i < FrameCounters.size(); i++)
+    {
+        FrameCounters[i].LastFrameValue = FrameCounters[i].Value;
+        FrameCounters[i].Value = 0;
+    }
+}
+
+void Profiler::Reset()
+{
+    for (unsigned int i = 0; i < Zones.size(); i++)
+    {
+        Zones[i].Calls = 0;
+        Zones[i].TotalSeconds = 0;
+        Zones[i].MaxSeconds = 0;
+        Zones[i].FrameSeconds = 0;
+        Zones[i].LastFrameSeconds = 0;
+        Zones[i].Units = 0;
+        Zones[i].Counters.Clear();
+    }
+}
+
+void Profiler::WriteReport( ostream &Out ) const
+{
+    Out << "Profile report\n";
+    Out << "Hardware counters: " << Counters.GetStatus() << "\n\n";
+
+    Out << left << setw(28) << "Zone" << right
+        << setw(10) << "Calls"
+        << setw(12) << "Total ms"
+        << setw(12) << "Avg us"
+        << setw(12) << "Max us"
+        << setw(14) << "Units" << '\n';
+
+    for (unsigned int i = 0; i < Zones.size(); i++)
+    {
+        const ProfileZoneStats &Zone = Zones[i];
+        double AvgSeconds = Zone.Calls > 0 ? Zone.TotalSeconds/Zone.Calls : 0;
+
+        Out << left << setw(28) << Zone.Name << right << fixed << setprecision(3)
+            << setw(10) << Zone.Calls
+            << setw(12) << Zone.TotalSeconds * 1000
+            << setw(12) << AvgSeconds * 1000000
+            << setw(12) << Zone.MaxSeconds * 1000000
+            << setw(14) << Zone.Units << '\n';
+    }
+
+    // Counter figures for sampled zones, normalized per call and per unit of work
+    bool HeaderWritten = false;
+    for (unsigned int i = 0; i < Zones.size(); i++)
+    {
+        const ProfileZoneStats &Zone = Zones[i];
+        if (!Zone.SampleCounters || Zone.Calls == 0)
+            continue;
+
+        if (!HeaderWritten)
+        {
+            Out << '\n' << left << setw(28) << "Zone" << right << setw(8) << "IPC";
+            for (int j = 0; j < PERF_NUM_EVENTS; j++)
+                Out << setw(16) << PerfCounterGroup::GetEventName( static_cast<PerfCounterEvent>(j) );
+            Out << "   (totals, then per unit)\n";
+            HeaderWritten = true;
+        }
+
+        const unsigned long long *Values = Zone.Counters.Values;
+        double IPC = Values[PERF_CYCLES] > 0 ? static_cast<double>(Values[PERF_INSTRUCTIONS])/Values[PERF_CYCLES] : 0;
+
+        Out << left << setw(28) << Zone.Name << right << fixed << setprecision(2) << setw(8) << IPC;
+        for (int j = 0; j < PERF_NUM_EVENTS; j++)
+        {
+            if (Counters.IsEventAvailable( static_cast<PerfCounterEvent>(j) ))
+                Out << setw(16) << Values[j];
+            else
+                Out << setw(16) << "n/a";
+        }
+        Out << '\n';
+
+        if (Zone.Units > 0)
+        {
+            Out << left << setw(28) << "  per unit" << right << setw(8) << "";
+            for (int j = 0; j < PERF_NUM_EVENTS; j++)
+            {
+                if (Counters.IsEventAvailable( static_cast<PerfCounterEvent>(j) ))
+                    Out << setw(16) << static_cast<double>(Values[j])/Zone.Units;
+                else
+                    Out << setw(16) << "n/a";
+            }
+            Out << '\n';
+        }
+    }
+}
+
+long long Profiler::GetTicks()
+{
+    return chrono::steady_clock::now().time_since_epoch().count();
+}
+
+double Profiler::GetSecondsPerTick()
+{
+    return static_cast<double>(chrono::steady_clock::period::num)/chrono::steady_clock::period::den;
+}
\ No newline at end of file
@@ -0,0 +1,239 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+
+
+// ------------------------------------------------------------------------------------
+// ----------------------------------Included headers----------------------------------
+// ------------------------------------------------------------------------------------
+
+// C++ standard library & STL
+#include <string>
+#include <vector>
+#include <ostream>
+
+// Utilities
+#include "..\Utilities\Singleton.h"
+#include "..\Utilities\PerfCounters.h"
+
+
+// ------------------------------------------------------------------------------------
+// --------------------------------------Structures------------------------------------
+// ------------------------------------------------------------------------------------
+
+// Accumulated measurements of a single named zone
+struct ProfileZoneStats
+{
+    ProfileZoneStats( const std::string &Name );
+
+    std::string Name;
+
+    unsigned long long Calls;
+    double TotalSeconds, MaxSeconds;
+
+    // Time spent in the zone during the current and the previous frame
+    double FrameSeconds, LastFrameSeconds;
+
+    // Work processed by the zone (e.g. snake segments), used to normalize counters
+    unsigned long long Units;
+
+    // Hardware counters, only gathered for zones with counter sampling enabled
+    bool SampleCounters;
+    PerfCounterValues Counters;
+};
+
+// Named per-frame event count (draw calls, collision tests, etc.)
+struct ProfileCounter
+{
+    ProfileCounter( const std::string &Name );
+
+    std::string Name;
+    long long Value, LastFrameValue;
+};
+
+// State captured on zone entry
+struct ProfileSample
+{
+    long long StartTicks;
+    PerfCounterValues StartCounters;
+};
+
+
+// ------------------------------------------------------------------------------------
+// ---------------------------------------Classes--------------------------------------
+// ------------------------------------------------------------------------------------
+
+// Collects timing and, optionally, hardware performance counters for named code zones.
+// Zones are registered once (see PROFILE_SCOPE) and referred to by index afterwards.
+// Counter sampling is opt-in per zone since reading the counters costs a system call.
+class Profiler
+{
+public:
+    Profiler();
+
+    // Register a zone, returns the existing index if a zone with that name exists
+    int RegisterZone( const char *Name );
+    // Register a per-frame counter, returns the existing index if one with that name exists
+    int RegisterCounter( const char *Name );
+
+    // Find a zone or counter by name, returns -1 if it was never registered
+    int FindZone( const char *Name ) const;
+    int FindCounter( const char *Name ) const;
+
+    // Enable counter sampling for a comma separated list of zone names, "*" enables all
+    // zones. Returns false if hardware counters are unavailable, timing still works.
+    bool EnableCounters( const std::string &ZoneNames );
+
+    // Zone measurement
+    void BeginZone( int ZoneID, ProfileSample &Sample );
+    void EndZone( int ZoneID, const ProfileSample &Sample );
+    inline void AddUnits( int ZoneID, unsigned long long Units );
+
+    // Per-frame counters
+    inline void AddCount( int CounterID, long long Count );
+    inline void SetCount( int CounterID, long long Count );
+
+    // Accessors
+    inline const std::vector<ProfileZoneStats> &GetZones() const;
+    inline const std::vector<ProfileCounter> &GetFrameCounters() const;
+    inline const PerfCounterGroup &GetCounters() const;
+    inline double GetLastFrameSeconds( int ZoneID ) const;
+    inline long long GetLastFrameCount( int CounterID ) const;
+
+    // Close the current frame, per-frame zone times and counters move to their last frame values
+    void EndFrame();
+
+    // Clear accumulated measurements
+    void Reset();
+
+    // Write a table of all zones with IPC and per-unit counter figures
+    void WriteReport( std::ostream &Out ) const;
+
+    // Current value of the high resolution clock and its frequency
+    static long long GetTicks();
+    static double GetSecondsPerTick();
+
+private:
+    std::vector<ProfileZoneStats> Zones;
+    std::vector<ProfileCounter> FrameCounters;
+    std::vector<std::string> CounterZoneNames;
+    bool CounterAllZones;
+
+    PerfCounterGroup Counters;
+};
+
+// Measures a zone for the lifetime of the object
+class ProfileScope
+{
+public:
+    inline ProfileScope( int ZoneID );
+    inline ~ProfileScope();
+
+    // Attribute units of work to the zone
+    inline void AddUnits( unsigned long long Units );
+
+private:
+    int ZoneID;
+    ProfileSample Sample;
+};
+
+
+// ------------------------------------------------------------------------------------
+// ----------------------------------------Macros--------------------------------------
+// ------------------------------------------------------------------------------------
+
+// Profile the rest of the enclosing block as a zone named Name. One per block.
+// Define DISABLE_PROFILER to compile all zones out.
+#ifndef DISABLE_PROFILER
+#define PROFILE_SCOPE( Name ) \
+    static const int ProfileZoneID = Singleton<Profiler>::Instance().RegisterZone( Name ); \
+    ProfileScope CurrentProfileScope( ProfileZoneID )
+#define PROFILE_UNITS( Units ) CurrentProfileScope.AddUnits( Units )
+
+// Add to, or set, the per-frame counter named Name
+#define PROFILE_COUNT( Name, Count ) \
+    do { \
+        static const int ProfileCounterID = Singleton<Profiler>::Instance().RegisterCounter( Name ); \
+        Singleton<Profiler>::Instance().AddCount( ProfileCounterID, Count ); \
+    } while (0)
+#define PROFILE_SET_COUNT( Name, Count ) \
+    do { \
+        static const int ProfileCounterID = Singleton<Profiler>::Instance().RegisterCounter( Name ); \
+        Singleton<Profiler>::Instance().SetCount( ProfileCounterID, Count ); \
+    } while (0)
+#else
+#define PROFILE_SCOPE( Name )
+#define PROFILE_UNITS( Units )
+#define PROFILE_COUNT( Name, Count )
+#define PROFILE_SET_COUNT( Name, Count )
+#endif
+
+
+// ------------------------------------------------------------------------------------
+// -----------------------------Inline function definitions----------------------------
+// ------------------------------------------------------------------------------------
+
+// ----------------------------------Profiler members----------------------------------
+
+void Profiler::AddUnits( int ZoneID, unsigned long long Units )
+{
+    Zones[ZoneID].Units += Units;
+}
+
+void Profiler::AddCount( int CounterID, long long Count )
+{
+    FrameCounters[CounterID].Value += Count;
+}
+
+void Profiler::SetCount( int CounterID, long long Count )
+{
+    FrameCounters[CounterID].Value = Count;
+}
+
+const std::vector<ProfileZoneStats> &Profiler::GetZones() const
+{
+    return Zones;
+}
+
+const std::vector<ProfileCounter> &Profiler::GetFrameCounters() const
+{
+    return FrameCounters;
+}
+
+double Profiler::GetLastFrameSeconds( int ZoneID ) const
+{
+    return Zones[ZoneID].LastFrameSeconds;
+}
+
+long long Profiler::GetLastFrameCount( int CounterID ) const
+{
+    return FrameCounters[CounterID].LastFrameValue;
+}
+
+const PerfCounterGroup &Profiler::GetCounters() const
+{
+    return Counters;
+}
+
+
+// --------------------------------ProfileScope members--------------------------------
+
+ProfileScope::ProfileScope( int ZoneID )
+: ZoneID(ZoneID)
+{
+    Singleton<Profiler>::Instance().BeginZone( ZoneID, Sample );
+}
+
+ProfileScope::~ProfileScope()
+{
+    Singleton<Profiler>::Instance().EndZone( ZoneID, Sample );
+}
+
+void ProfileScope::AddUnits( unsigned long long Units )
+{
+    Singleton<Profiler>::Instance().AddUnits( ZoneID, Units );
+}
+
+
+
+#endif
\ No newline at end of file
@@ -25,6 +25,10 @@ inline T Rand( T Min, T Max);
 template<int N, int M, typename T>
 Matrix<N, M, T> RandomMatrix( T Min, T Max);
 
+// As above, drawing from the given generator instead of the global one
+template<int N, int M, typename T>
+Matrix<N, M, T> RandomMatrix( MersenneTwister &Generator, T Min, T Max);
+
 
 // ------------------------------------------------------------------------------------
 // ----------------------Inline & templatized function definitions---------------------
@@ -38,10 +42,16 @@ T Rand( T Min, T Max)
 
 template<int N, int M, typename T>
 Matrix<N, M, T> RandomMatrix( T Min, T Max)
+{
+    return RandomMatrix<N, M, T>( Singleton<MersenneTwister>::Instance(), Min, Max );
+}
+
+template<int N, int M, typename T>
+Matrix<N, M, T> RandomMatrix( MersenneTwister &Generator, T Min, T Max)
 {
     Matrix<N, M, T> result;
     for (int i = 0; i < N*M; i++)
-        result[i] = Rand( Min, Max );
+        result[i] = Generator.Next( Min, Max );
 
     return result;
 }
@@ -0,0 +1,80 @@
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+
+
+// ------------------------------------------------------------------------------------
+// ----------------------------------Included headers----------------------------------
+// ------------------------------------------------------------------------------------
+
+// C++ standard library
+#include <atomic>
+
+
+// ------------------------------------------------------------------------------------
+// --------------------Templatized class declarations & definitions--------------------
+// ------------------------------------------------------------------------------------
+
+// Bounded wait-free queue for exactly one producer thread and one consumer thread.
+// Items live in a fixed array, so pushing never allocates. Capacity must be a power of two.
+template <typename T, unsigned int Capacity>
+class SPSCQueue
+{
+public:
+    SPSCQueue()
+    : Tail(0), Head(0)
+    {
+    }
+
+    // Producer side. Returns false, leaving the queue unchanged, if it is full.
+    bool TryPush( const T &Item )
+    {
+        unsigned int CurTail = Tail.load( std::memory_order_relaxed );
+        if (CurTail - Head.load( std::memory_order_acquire ) == Capacity)
+            return false;
+
+        Items[CurTail & (Capacity - 1)] = Item;
+
+        // Publish the item to the consumer
+        Tail.store( CurTail + 1, std::memory_order_release );
+        return true;
+    }
+
+    // Consumer side. Returns false if the queue is empty.
+    bool TryPop( T &Item )
+    {
+        unsigned int CurHead = Head.load( std::memory_order_relaxed );
+        if (CurHead == Tail.load( std::memory_order_acquire ))
+            return false;
+
+        Item = Items[CurHead & (Capacity - 1)];
+
+        // Hand the slot back to the producer
+        Head.store( CurHead + 1, std::memory_order_release );
+        return true;
+    }
+
+    // Exact only on the consumer thread when the producer is idle
+    unsigned int GetSize() const
+    {
+        return Tail.load( std::memory_order_acquire ) - Head.load( std::memory_order_acquire );
+    }
+
+private:
+    static_assert( Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "SPSCQueue capacity must be a power of two" );
+
+    // Free-running indices, wrapped on access. Each is written by one side only, and they
+    // are kept on separate cache lines so the two threads don't contend for one line.
+    alignas(64) std::atomic<unsigned int> Tail;
+    alignas(64) std::atomic<unsigned int> Head;
+
+    alignas(64) T Items[Capacity];
+
+    // Disable copying
+    SPSCQueue( const SPSCQueue & );
+    SPSCQueue &operator = ( const SPSCQueue & );
+};
+
+
+
+#endif
\ No newline at end of file
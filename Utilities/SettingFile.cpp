@@ -5,15 +5,86 @@
 
 // C++ standard library & STL
 #include <string>
+#include <string_view>
+#include <charconv>
 #include <iostream>
 #include <fstream>
-#include <map>
+#include <vector>
+#include <algorithm>
 using namespace std;
 
 // Utilities
+#include "MappedFile.h"
 #include "Exceptions.h"
 
 
+// ------------------------------------------------------------------------------------
+// ----------------------------------Static functions----------------------------------
+// ------------------------------------------------------------------------------------
+
+// Bits of Setting::Parsed
+enum
+{
+    PARSED_INTEGER = 1,
+    PARSED_UNSIGNED = 2,
+    PARSED_FLOAT = 4
+};
+
+// Helpers for SettingFile::Setting, templated since the type is private to SettingFile
+
+// Order settings by name
+template <typename SettingType>
+static bool NameLess( const SettingType &Left, const SettingType &Right )
+{
+    return Left.Name < Right.Name;
+}
+
+// Order a setting before a name
+template <typename SettingType>
+static bool NameLessThan( const SettingType &Left, const char *Name )
+{
+    return Left.Name.compare( Name ) < 0;
+}
+
+// Error message for a line of a settings file
+static string LineError( int Line, const string &Cause )
+{
+    return "Line " + to_string( Line ) + ": " + Cause;
+}
+
+// Error message for a value that isn't a number of the requested kind
+template <typename SettingType>
+static string ValueError( const SettingType &Found, const char *Kind )
+{
+    string Cause = "Setting \"" + Found.Name + "\" value \"" + Found.Value + "\" is not " + Kind + ".";
+    return Found.Line > 0 ? LineError( Found.Line, Cause ) : Cause;
+}
+
+// Value without surrounding blanks
+static string_view Trim( string_view Text )
+{
+    size_t Begin = Text.find_first_not_of( " \t" );
+    if (Begin == string_view::npos)
+        return string_view();
+
+    size_t End = Text.find_last_not_of( " \t" );
+    return Text.substr( Begin, End - Begin + 1 );
+}
+
+// Parse the whole of Text as a number, false if anything is left over
+template <typename T>
+static bool ParseNumber( string_view Text, T &Value, int Base = 10 )
+{
+    from_chars_result Result;
+    if constexpr (is_floating_point<T>::value)
+        Result = from_chars( Text.data(), Text.data() + Text.size(), Value );
+    else
+        Result = from_chars( Text.data(), Text.data() + Text.size(), Value, Base );
+
+    return Result.ec == errc() && Result.ptr == Text.data() + Text.size();
+}
+
+
 // ------------------------------------------------------------------------------------
 // ---------------------------------SettingFile Members--------------------------------
 // ------------------------------------------------------------------------------------
@@ -29,37 +100,79 @@ SettingFile::SettingFile( const char *FilePath )
 
 void SettingFile::Load( const char *FilePath )
 {
-    // Empty map
-    if (SettingMap.size() > 0)
-        SettingMap.clear();
+    // Map the file and parse it in place, no line is copied before it is known to be valid
+    MappedFile File( FilePath );
+    Parse( FilePath, File.GetData(), File.GetSize() );
+}
 
-    // Open file
-    ifstream fin( FilePath );
-    if (!fin.good())
+void SettingFile::Reload( const char *FilePath )
+{
+    // Copy the file rather than map it. Pages of a mapping that a writer truncates away
+    // fault when touched, a copy just comes out short.
+    ifstream fin( FilePath, ios::in | ios::binary );
+    if (!fin.is_open())
         throw FileNotFoundException( FilePath );
 
-    // Iterate through lines on file
-    char NameBuffer[100], ValueBuffer[100];
-    while (!fin.eof())
+    string Text( (istreambuf_iterator<char>( fin )), istreambuf_iterator<char>() );
+    if (fin.bad())
+        throw FileIOException( FilePath, "Failed to read file." );
+
+    Parse( FilePath, Text.data(), Text.size() );
+}
+
+void SettingFile::Parse( const char *FilePath, const char *Data, size_t Size )
+{
+    string_view Text( Data, Size );
+
+    // Parse into a new array so the current settings survive a failed load
+    vector<Setting> Settings;
+    Settings.reserve( count( Text.begin(), Text.end(), '\n' ) + 1 );
+
+    int Line = 0;
+    for (size_t LineBegin = 0; LineBegin < Text.size(); )
     {
-        // Read setting name
-        fin.getline( NameBuffer, 100, ' ' );
-        if (!fin.good())
-            throw FileIOException( FilePath, "Settings data is corrupt." );
+        size_t LineEnd = Text.find( '\n', LineBegin );
+        if (LineEnd == string_view::npos)
+            LineEnd = Text.size();
+
+        string_view LineText = Text.substr( LineBegin, LineEnd - LineBegin );
+        LineBegin = LineEnd + 1;
+        Line++;
 
-        // Read setting value
-        fin.getline( ValueBuffer, 100, '\n' );
-        if (!fin.good())
-            throw FileIOException( FilePath, "Settings data is corrupt." );
+        if (!LineText.empty() && LineText.back() == '\r')
+            LineText.remove_suffix( 1 );
 
-        // Insert setting into map
-        SettingMap.insert( make_pair<string, string>(NameBuffer, ValueBuffer) );
+        if (Trim( LineText ).empty())
+            continue;
 
-        // Peek to set eofbit if end of file is met
-        fin.peek();
+        // Name runs up to the first space, the value is the rest of the line
+        size_t Space = LineText.find( ' ' );
+        if (Space == string_view::npos || Space == 0)
+            throw FileIOException( FilePath, LineError( Line, "Expected a setting name, a space and a value, found \"" + string( LineText ) + "\"." ) );
+
+        Settings.push_back( Setting() );
+        Setting &NewSetting = Settings.back();
+        NewSetting.Name.assign( LineText.data(), Space );
+        NewSetting.Value.assign( LineText.data() + Space + 1, LineText.size() - Space - 1 );
+        NewSetting.Line = Line;
+        NewSetting.Parsed = 0;
     }
 
-    fin.close();
+    // An empty file is most likely one caught mid-save, keep the current settings
+    if (Settings.empty())
+        throw FileIOException( FilePath, "File contains no settings." );
+
+    // Sort once. Stable, so duplicates stay in file order and the error names the later line.
+    stable_sort( Settings.begin(), Settings.end(), NameLess<Setting> );
+
+    for (size_t i = 1; i < Settings.size(); i++)
+    {
+        if (Settings[i].Name == Settings[i - 1].Name)
+            throw FileIOException( FilePath, LineError( Settings[i].Line, "Setting \"" + Settings[i].Name +
+                                                        "\" is already defined on line " + to_string( Settings[i - 1].Line ) + "." ) );
+    }
+
+    this->Settings.swap( Settings );
 }
 
 void SettingFile::Save( const char *FilePath ) const
@@ -69,13 +182,13 @@ void SettingFile::Save( const char *FilePath ) const
     if (!fout.good())
         throw FileIOException( FilePath, "Failed to create settings file." );
 
-    // Iterate through setting map
-    for (map<string, string>::const_iterator it = SettingMap.begin(); it != SettingMap.end(); ++it)
+    // Iterate through settings
+    for (vector<Setting>::const_iterator it = Settings.begin(); it != Settings.end(); ++it)
     {
         // Write setting name & value
-        fout << (*it).first;
+        fout << (*it).Name;
         fout << ' ';
-        fout << (*it).second;
+        fout << (*it).Value;
         fout << '\n';
 
         if (!fout.good())
@@ -87,36 +200,118 @@ void SettingFile::Save( const char *FilePath ) const
 
 const string &SettingFile::GetValue( const char *Name ) const
 {
-    // Find setting
-    map<string, string>::const_iterator it = SettingMap.find( Name );
-
-    // Assure it was found
-    if (it == SettingMap.end())
-        throw LogicException( string() + "Setting name \"" + Name + "\" not found." );
+    return Get( Name ).Value;
+}
 
-    return (*it).second;
+bool SettingFile::HasSetting( const char *Name ) const
+{
+    return Find( Name ) != NULL;
 }
 
 void SettingFile::SetValue( const char *Name, const char *Value )
 {
-    // Find setting
-    map<string, string>::iterator it = SettingMap.find( Name );
-
-    // Assure it was found
-    if (it == SettingMap.end())
-        throw LogicException( string() + "Setting name \"" + Name + "\" not found." );
+    Setting &Found = const_cast<Setting &>(Get( Name ));
 
-    (*it).second = Value;
+    Found.Value = Value;
+    Found.Parsed = 0;
 }
 
 void SettingFile::AddSetting( const char *Name, const char *Value )
 {
-    if (SettingMap.insert( make_pair<string, string>(Name, Value) ).second == false)
+    vector<Setting>::iterator it = lower_bound( Settings.begin(), Settings.end(), Name, NameLessThan<Setting> );
+    if (it != Settings.end() && (*it).Name == Name)
         throw LogicException( string() + "Setting name \"" + Name + "\" already in use." );
+
+    Setting NewSetting;
+    NewSetting.Name = Name;
+    NewSetting.Value = Value;
+    NewSetting.Line = 0;
+    NewSetting.Parsed = 0;
+    Settings.insert( it, NewSetting );
 }
 
 void SettingFile::RemoveSetting( const char *Name )
 {
-    if (SettingMap.erase( Name ) == 0)
+    const Setting &Found = Get( Name );
+
+    Settings.erase( Settings.begin() + (&Found - &Settings[0]) );
+}
+
+const SettingFile::Setting *SettingFile::Find( const char *Name ) const
+{
+    vector<Setting>::const_iterator it = lower_bound( Settings.begin(), Settings.end(), Name, NameLessThan<Setting> );
+    if (it == Settings.end() || (*it).Name != Name)
+        return NULL;
+
+    return &*it;
+}
+
+const SettingFile::Setting &SettingFile::Get( const char *Name ) const
+{
+    const Setting *Found = Find( Name );
+
+    // Assure it was found
+    if (Found == NULL)
         throw LogicException( string() + "Setting name \"" + Name + "\" not found." );
+
+    return *Found;
+}
+
+long long SettingFile::GetInteger( const Setting &Found )
+{
+    if (!(Found.Parsed & PARSED_INTEGER))
+    {
+        string_view Text = Trim( Found.Value );
+        if (!Text.empty() && Text[0] == '+')
+            Text.remove_prefix( 1 );
+
+        if (!ParseNumber( Text, Found.Integer ))
+            throw LogicException( ValueError( Found, "an integer" ) );
+
+        Found.Parsed |= PARSED_INTEGER;
+    }
+
+    return Found.Integer;
+}
+
+unsigned long long SettingFile::GetUnsigned( const Setting &Found )
+{
+    if (!(Found.Parsed & PARSED_UNSIGNED))
+    {
+        string_view Text = Trim( Found.Value );
+        if (!Text.empty() && Text[0] == '+')
+            Text.remove_prefix( 1 );
+
+        // Hexadecimal with a 0x prefix, as the strtoul based parser accepted
+        int Base = 10;
+        if (Text.size() > 2 && Text[0] == '0' && (Text[1] == 'x' || Text[1] == 'X'))
+        {
+            Text.remove_prefix( 2 );
+            Base = 16;
+        }
+
+        if (!ParseNumber( Text, Found.Unsigned, Base ))
+            throw LogicException( ValueError( Found, "an unsigned integer" ) );
+
+        Found.Parsed |= PARSED_UNSIGNED;
+    }
+
+    return Found.Unsigned;
+}
+
+double SettingFile::GetFloat( const Setting &Found )
+{
+    if (!(Found.Parsed & PARSED_FLOAT))
+    {
+        string_view Text = Trim( Found.Value );
+        if (!Text.empty() && Text[0] == '+')
+            Text.remove_prefix( 1 );
+
+        if (!ParseNumber( Text, Found.Float ))
+            throw LogicException( ValueError( Found, "a number" ) );
+
+        Found.Parsed |= PARSED_FLOAT;
+    }
+
+    return Found.Float;
 }
\ No newline at end of file
@@ -8,8 +8,10 @@
 // ------------------------------------------------------------------------------------
 
 // C++ standard library & STL
+#include <cstddef>
 #include <string>
-#include <map>
+#include <vector>
+#include <type_traits>
 
 // Utilities
 #include "..\Utilities\TMath.h"
@@ -22,6 +24,8 @@
 /// Manages a text settings file.
 /// Manages a collection of name and value pairs that represent settings. Settings are
 /// saved to file one per line, with a single space between the setting name and value.
+/// Files are memory mapped (or read, on reload) and parsed in place, and settings are kept in a flat array
+/// sorted by name. Numeric values are parsed on first use only.
 class SettingFile
 {
 public:
@@ -33,9 +37,17 @@ public:
     SettingFile( const char *FilePath );
 
     /// Load settings from text file.
+    /// Lines may be any length, blank lines are skipped. Malformed lines and duplicate
+    /// names throw a FileIOException giving the line number, as does a file with no settings
+    /// at all. Settings are left unchanged if loading fails.
     /// - May throw: FileIOException, FileNotFoundException
     void Load( const char *FilePath );
 
+    /// Load settings from a text file that may be rewritten while it is read, as on hot
+    /// reload. The file is read into memory rather than mapped, otherwise as Load().
+    /// - May throw: FileIOException, FileNotFoundException
+    void Reload( const char *FilePath );
+
     /// Save settings to text file.
     /// - May throw: FileIOException
     void Save( const char *FilePath ) const;
@@ -44,11 +56,21 @@ public:
     /// - May throw: LogicException
     const std::string &GetValue( const char *Name ) const;
 
+    /// Check whether a setting with name Name exists.
+    bool HasSetting( const char *Name ) const;
+
     template<typename T>
     /// Get value of setting with name Name as type T.
+    /// Arithmetic types are parsed strictly, throwing a LogicException if the value isn't a
+    /// number of that kind. Unsigned values may be hexadecimal with a 0x prefix.
     /// - May throw: LogicException
     inline T GetValueAs( const char *Name ) const;
 
+    template<typename T>
+    /// Get value of setting with name Name as type T, or Default if there is no such setting.
+    /// - May throw: LogicException
+    inline T GetValueAs( const char *Name, T Default ) const;
+
     /// Set value of setting with name Name.
     /// - May throw: LogicException
     void SetValue( const char *Name, const char *Value );
@@ -64,7 +86,39 @@ public:
     void RemoveSetting( const char *Name );
 
 private:
-    std::map<std::string, std::string> SettingMap;
+    struct Setting
+    {
+        std::string Name, Value;
+
+        // Line the setting was loaded from, 0 if it was added afterwards
+        int Line;
+
+        // Value parsed as each kind of number, valid if the matching Parsed flag is set
+        mutable unsigned char Parsed;
+        mutable long long Integer;
+        mutable unsigned long long Unsigned;
+        mutable double Float;
+    };
+
+    // Sorted by name
+    std::vector<Setting> Settings;
+
+
+    // Parse Size bytes at Data into the settings, FilePath only names the file in errors
+    // - May throw: FileIOException
+    void Parse( const char *FilePath, const char *Data, size_t Size );
+
+    // Setting with name Name, or NULL
+    const Setting *Find( const char *Name ) const;
+    // Setting with name Name
+    // - May throw: LogicException
+    const Setting &Get( const char *Name ) const;
+
+    // Parse and cache the value as a number
+    // - May throw: LogicException
+    static long long GetInteger( const Setting &Found );
+    static unsigned long long GetUnsigned( const Setting &Found );
+    static double GetFloat( const Setting &Found );
 };
 
 
@@ -75,7 +129,24 @@ private:
 template<typename T>
 T SettingFile::GetValueAs( const char *Name ) const
 {
-    return TMath::StrToT<T>( GetValue( Name ).c_str() );
+    const Setting &Found = Get( Name );
+
+    if constexpr (std::is_same<T, bool>::value)
+        return GetUnsigned( Found ) != 0;
+    else if constexpr (std::is_integral<T>::value && std::is_signed<T>::value)
+        return static_cast<T>(GetInteger( Found ));
+    else if constexpr (std::is_integral<T>::value)
+        return static_cast<T>(GetUnsigned( Found ));
+    else if constexpr (std::is_floating_point<T>::value)
+        return static_cast<T>(GetFloat( Found ));
+    else
+        return TMath::StrToT<T>( Found.Value.c_str() );
+}
+
+template<typename T>
+T SettingFile::GetValueAs( const char *Name, T Default ) const
+{
+    return Find( Name ) != NULL ? GetValueAs<T>( Name ) : Default;
 }
 
 
@@ -8,6 +8,11 @@
 // ------------------------------------------------------------------------------------
 #include <cstddef>
 #include <stdexcept>
+#include <atomic>
+#include <mutex>
+
+// Utilities
+#include "Template Utils.h"
 
 
 // ------------------------------------------------------------------------------------
@@ -15,12 +20,17 @@
 // ------------------------------------------------------------------------------------
 
 // ------------------Creation policies for Singleton-------------------
+// Policies with ManagesInstance == false only create and destroy the object, Singleton
+// stores the pointer and creation is not thread-safe. Policies with ManagesInstance == true
+// store the instance themselves and Singleton::Instance() forwards to their Instance().
 
 // Create with new and destroy with delete
 template <typename T>
 class NewOperatorCreation
 {
 public:
+	static const bool ManagesInstance = false;
+
 	static T *Create()
 	{ return new T; }
 
@@ -36,6 +46,8 @@ template <typename T>
 class StaticCreation
 {
 public:
+	static const bool ManagesInstance = false;
+
 	// Creates a local static variable and returns a pointer to it
 	static T *Create()
 	{
@@ -46,6 +58,89 @@ public:
 	static void Destroy(T *tObject) {}
 };
 
+// Thread-safe. Creates a local static variable, whose initialization C++11 guarantees to be
+// thread-safe. The runtime destroys it at exit, so the lifetime policy is not used.
+template <typename T>
+class MagicStaticCreation
+{
+public:
+	static const bool ManagesInstance = true;
+
+	template <template <class> class LifetimePolicy>
+	static T &Instance()
+	{
+		static T tInstance;
+		return tInstance;
+	}
+};
+
+// Thread-safe. Create with new under double-checked locking of an atomic pointer, after
+// creation each access is a single acquire load. Destruction follows the lifetime policy.
+template <typename T>
+class AtomicDoubleCheckedCreation
+{
+public:
+	static const bool ManagesInstance = true;
+
+	template <template <class> class LifetimePolicy>
+	static T &Instance()
+	{
+		T *pTemp = pInstance.load(std::memory_order_acquire);
+		if (!pTemp)
+		{
+			std::lock_guard<std::mutex> Lock(GetMutex());
+
+			pTemp = pInstance.load(std::memory_order_relaxed);
+			if (!pTemp)
+			{
+				if (bDestroyed)
+				{
+					LifetimePolicy<T>::OnDeadReference();
+					bDestroyed = false;
+				}
+				pTemp = new T;
+				pInstance.store(pTemp, std::memory_order_release);
+				LifetimePolicy<T>::ScheduleDestruction(&Destroy);
+			}
+		}
+
+		return *pTemp;
+	}
+
+private:
+	static std::atomic<T *> pInstance;
+	static bool bDestroyed;
+
+	// Function-local so the mutex exists before any static initializer can use the singleton
+	static std::mutex &GetMutex()
+	{
+		static std::mutex Mutex;
+		return Mutex;
+	}
+
+	static void Destroy()
+	{
+		delete pInstance.exchange(NULL);
+		bDestroyed = true;
+	}
+};
+
+// One instance per thread, created on the thread's first access and destroyed when the
+// thread exits. No synchronization is needed, but instances are not shared between threads.
+template <typename T>
+class ThreadLocalCreation
+{
+public:
+	static const bool ManagesInstance = true;
+
+	template <template <class> class LifetimePolicy>
+	static T &Instance()
+	{
+		thread_local T tInstance;
+		return tInstance;
+	}
+};
+
 
 // ------------------Lifetime policies for Singleton-------------------
 
@@ -105,6 +200,22 @@ class Singleton
 public:
 	// Retrieve instance of singleton, uses lazy initialization
 	static T &Instance()
+	{
+		return Instance(Int2Type<CreationPolicy<T>::ManagesInstance>());
+	}
+
+private:
+	static T *pInstance;
+	static bool bDestroyed;
+
+	// Creation policy stores the instance and synchronizes its creation
+	static T &Instance(Int2Type<true>)
+	{
+		return CreationPolicy<T>::template Instance<LifetimePolicy>();
+	}
+
+	// Singleton stores the instance, creation is not thread-safe
+	static T &Instance(Int2Type<false>)
 	{
 		if (!pInstance)
 		{
@@ -120,10 +231,6 @@ public:
 		return *pInstance;
 	}
 
-private:
-	static T *pInstance;
-	static bool bDestroyed;
-
 	// Destroy singleton, called by lifetime policy
 	static void DestroySingleton()
 	{
@@ -152,6 +259,12 @@ template <typename T,
 		  template <class> class LifetimePolicy>
 bool Singleton<T, CreationPolicy, LifetimePolicy>::bDestroyed = false;
 
+template <typename T>
+std::atomic<T *> AtomicDoubleCheckedCreation<T>::pInstance(NULL);
+
+template <typename T>
+bool AtomicDoubleCheckedCreation<T>::bDestroyed = false;
+
 
 
 #endif
\ No newline at end of file
@@ -0,0 +1,62 @@
+// ------------------------------------------------------------------------------------
+// ----------------------------------Included headers----------------------------------
+// ------------------------------------------------------------------------------------
+#include "SpatialHash.h"
+
+// C++ standard library & STL
+#include <vector>
+using namespace std;
+
+
+// ------------------------------------------------------------------------------------
+// ---------------------------------SpatialHash Members--------------------------------
+// ------------------------------------------------------------------------------------
+
+SpatialHash::SpatialHash()
+: CellSize(1), InverseCellSize(1)
+{
+}
+
+void SpatialHash::Reset( unsigned int NumSlots, float CellSize )
+{
+    this->CellSize = CellSize;
+    InverseCellSize = 1 / CellSize;
+
+    // As many buckets as slots keeps the chains short at any fill
+    Buckets.assign( NumSlots, -1 );
+    SlotBuckets.assign( NumSlots, -1 );
+    Next.resize( NumSlots );
+    Previous.resize( NumSlots );
+}
+
+void SpatialHash::Insert( unsigned int Slot, const Vector3f &Position )
+{
+    unsigned int Bucket = GetBucket( GetCell( Position.x() ), GetCell( Position.y() ), GetCell( Position.z() ) );
+
+    // Push to the front of the bucket's list
+    int First = Buckets[Bucket];
+    Next[Slot] = First;
+    Previous[Slot] = -1;
+    if (First >= 0)
+        Previous[First] = Slot;
+
+    Buckets[Bucket] = Slot;
+    SlotBuckets[Slot] = Bucket;
+}
+
+void SpatialHash::Remove( unsigned int Slot )
+{
+    int Bucket = SlotBuckets[Slot];
+    if (Bucket < 0)
+        return;
+
+    if (Previous[Slot] >= 0)
+        Next[Previous[Slot]] = Next[Slot];
+    else
+        Buckets[Bucket] = Next[Slot];
+
+    if (Next[Slot] >= 0)
+        Previous[Next[Slot]] = Previous[Slot];
+
+    SlotBuckets[Slot] = -1;
+}
\ No newline at end of file
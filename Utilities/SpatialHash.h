@@ -0,0 +1,137 @@
+#ifndef SPATIALHASH_H
+#define SPATIALHASH_H
+
+
+
+// ------------------------------------------------------------------------------------
+// ----------------------------------Included headers----------------------------------
+// ------------------------------------------------------------------------------------
+
+// C++ standard library & STL
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+// Utilities
+#include "Matrix.h"
+
+
+// ------------------------------------------------------------------------------------
+// ---------------------------------------Classes--------------------------------------
+// ------------------------------------------------------------------------------------
+
+// Uniform grid of cubic cells over unbounded space, hashed into a fixed number of buckets.
+// Entries are slot indices in [0, NumSlots) into storage owned by the caller, and are
+// inserted and removed individually in O(1) as objects move. Each bucket chains its slots
+// in a doubly linked list. Cells that hash to the same bucket share it, so queries return
+// a superset of the neighbours and the caller does the exact test.
+class SpatialHash
+{
+public:
+    // Bytes of bookkeeping per slot, including its share of the buckets
+    static const size_t BytesPerSlot = 4 * sizeof(int);
+
+    SpatialHash();
+
+    // Remove every slot and size for NumSlots slots, a power of two. Memory is reused when
+    // NumSlots doesn't grow.
+    void Reset( unsigned int NumSlots, float CellSize );
+
+    // Add Slot at Position. Slot must not be in the grid.
+    void Insert( unsigned int Slot, const Vector3f &Position );
+    // Remove Slot, if it is in the grid
+    void Remove( unsigned int Slot );
+
+    // Call Visit( Slot ) for the slots in the 27 cells around Position, i.e. every slot within
+    // one cell size of it and possibly others, each slot once. Stops and returns true as soon
+    // as Visit does.
+    template <typename Visitor>
+    bool Query( const Vector3f &Position, Visitor &Visit ) const;
+
+    // Accessors
+    inline float GetCellSize() const;
+    inline size_t GetReservedBytes() const;
+
+private:
+    float CellSize, InverseCellSize;
+
+    // First slot of each bucket's list, -1 if empty
+    std::vector<int> Buckets;
+    // Per slot: bucket it is in (-1 if not in the grid) and its list links
+    std::vector<int> SlotBuckets, Next, Previous;
+
+
+    inline int GetCell( float Coordinate ) const;
+    inline unsigned int GetBucket( int CellX, int CellY, int CellZ ) const;
+};
+
+
+// ------------------------------------------------------------------------------------
+// -----------------------------Inline function definitions----------------------------
+// ------------------------------------------------------------------------------------
+
+float SpatialHash::GetCellSize() const
+{
+    return CellSize;
+}
+
+size_t SpatialHash::GetReservedBytes() const
+{
+    return (Buckets.capacity() + SlotBuckets.capacity() + Next.capacity() + Previous.capacity()) * sizeof(int);
+}
+
+int SpatialHash::GetCell( float Coordinate ) const
+{
+    float Cell = Coordinate * InverseCellSize;
+    int Truncated = static_cast<int>(Cell);
+    return Truncated > Cell ? Truncated - 1 : Truncated;
+}
+
+unsigned int SpatialHash::GetBucket( int CellX, int CellY, int CellZ ) const
+{
+    // Large primes, as in Teschner et al., "Optimized Spatial Hashing for Collision Detection of Deformable Objects"
+    unsigned int Hash = (static_cast<unsigned int>(CellX) * 73856093u) ^
+                        (static_cast<unsigned int>(CellY) * 19349663u) ^
+                        (static_cast<unsigned int>(CellZ) * 83492791u);
+    return Hash & static_cast<unsigned int>(Buckets.size() - 1);
+}
+
+
+// ------------------------------------------------------------------------------------
+// ---------------------------Templatized member definitions---------------------------
+// ------------------------------------------------------------------------------------
+
+template <typename Visitor>
+bool SpatialHash::Query( const Vector3f &Position, Visitor &Visit ) const
+{
+    if (Buckets.empty())
+        return false;
+
+    int CellX = GetCell( Position.x() ), CellY = GetCell( Position.y() ), CellZ = GetCell( Position.z() );
+
+    // Neighbouring cells may share a bucket, walk each bucket only once
+    unsigned int Visited[27];
+    int NumVisited = 0;
+
+    for (int x = CellX - 1; x <= CellX + 1; x++)
+        for (int y = CellY - 1; y <= CellY + 1; y++)
+            for (int z = CellZ - 1; z <= CellZ + 1; z++)
+            {
+                unsigned int Bucket = GetBucket( x, y, z );
+                if (std::find( Visited, Visited + NumVisited, Bucket ) != Visited + NumVisited)
+                    continue;
+                Visited[NumVisited++] = Bucket;
+
+                for (int Slot = Buckets[Bucket]; Slot >= 0; Slot = Next[Slot])
+                {
+                    if (Visit( static_cast<unsigned int>(Slot) ))
+                        return true;
+                }
+            }
+
+    return false;
+}
+
+
+
+#endif
\ No newline at end of file
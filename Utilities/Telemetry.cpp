@@ -0,0 +1,340 @@
+// ------------------------------------------------------------------------------------
+// ----------------------------------Included headers----------------------------------
+// ------------------------------------------------------------------------------------
+#include "Telemetry.h"
+
+// C standard library
+#include <cstddef>
+#include <cstring>
+
+// C++ standard library
+#include <atomic>
+#include <string>
+using namespace std;
+
+#if defined(_WIN32)
+// Windows
+#include <Windows.h>
+#else
+// POSIX shared memory
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+// ------------------------------------------------------------------------------------
+// ---------------------------------SharedMemory Members-------------------------------
+// ------------------------------------------------------------------------------------
+
+// Platform specific object name for a shared memory block
+static string GetPlatformName( const string &Name )
+{
+#if defined(_WIN32)
+    return "Local\\" + Name;
+#else
+    return "/" + Name;
+#endif
+}
+
+SharedMemory::SharedMemory()
+: Data(NULL), Size(0), Owner(false)
+#if defined(_WIN32)
+, Mapping(NULL)
+#endif
+{
+}
+
+SharedMemory::~SharedMemory()
+{
+    Close();
+}
+
+bool SharedMemory::Create( const string &Name, unsigned int Size )
+{
+    Close();
+
+    string PlatformName = GetPlatformName( Name );
+
+#if defined(_WIN32)
+    Mapping = CreateFileMappingA( INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, 0, Size, PlatformName.c_str() );
+    if (Mapping == NULL)
+        return false;
+
+    Data = MapViewOfFile( Mapping, FILE_MAP_ALL_ACCESS, 0, 0, Size );
+    if (Data == NULL)
+    {
+        CloseHandle( Mapping );
+        Mapping = NULL;
+        return false;
+    }
+#else
+    int FD = shm_open( PlatformName.c_str(), O_CREAT | O_RDWR, 0644 );
+    if (FD == -1)
+        return false;
+
+    if (ftruncate( FD, Size ) != 0)
+    {
+        close( FD );
+        return false;
+    }
+
+    Data = mmap( NULL, Size, PROT_READ | PROT_WRITE, MAP_SHARED, FD, 0 );
+    close( FD );
+
+    if (Data == MAP_FAILED)
+    {
+        Data = NULL;
+        return false;
+    }
+#endif
+
+    this->Name = PlatformName;
+    this->Size = Size;
+    Owner = true;
+
+    return true;
+}
+
+bool SharedMemory::OpenReadOnly( const string &Name )
+{
+    Close();
+
+    string PlatformName = GetPlatformName( Name );
+
+#if defined(_WIN32)
+    Mapping = OpenFileMappingA( FILE_MAP_READ, FALSE, PlatformName.c_str() );
+    if (Mapping == NULL)
+        return false;
+
+    Data = MapViewOfFile( Mapping, FILE_MAP_READ, 0, 0, 0 );
+    if (Data == NULL)
+    {
+        CloseHandle( Mapping );
+        Mapping = NULL;
+        return false;
+    }
+
+    MEMORY_BASIC_INFORMATION Info;
+    VirtualQuery( Data, &Info, sizeof(Info) );
+    Size = static_cast<unsigned int>(Info.RegionSize);
+#else
+    int FD = shm_open( PlatformName.c_str(), O_RDONLY, 0 );
+    if (FD == -1)
+        return false;
+
+    struct stat Status;
+    if (fstat( FD, &Status ) != 0 || Status.st_size == 0)
+    {
+        close( FD );
+        return false;
+    }
+
+    Data = mmap( NULL, Status.st_size, PROT_READ, MAP_SHARED, FD, 0 );
+    close( FD );
+
+    if (Data == MAP_FAILED)
+    {
+        Data = NULL;
+        return false;
+    }
+
+    Size = static_cast<unsigned int>(Status.st_size);
+#endif
+
+    this->Name = PlatformName;
+    Owner = false;
+
+    return true;
+}
+
+void SharedMemory::Close()
+{
+    if (Data == NULL)
+        return;
+
+#if defined(_WIN32)
+    UnmapViewOfFile( Data );
+    CloseHandle( Mapping );
+    Mapping = NULL;
+#else
+    munmap( Data, Size );
+
+    // The creator removes the name, readers keep their mapping until they close it
+    if (Owner)
+        shm_unlink( Name.c_str() );
+#endif
+
+    Data = NULL;
+    Size = 0;
+    Owner = false;
+}
+
+
+// ------------------------------------------------------------------------------------
+// ------------------------------TelemetryPublisher Members----------------------------
+// ------------------------------------------------------------------------------------
+
+TelemetryPublisher::TelemetryPublisher()
+: Header(NULL), Slots(NULL), Mask(0)
+{
+}
+
+bool TelemetryPublisher::Open( const string &Name, unsigned int Capacity )
+{
+    Close();
+
+    // Power of two capacity so the slot index is a mask
+    unsigned int RoundedCapacity = 1;
+    while (RoundedCapacity < Capacity)
+        RoundedCapacity <<= 1;
+
+    unsigned int Size = sizeof(TelemetryHeader) + RoundedCapacity * sizeof(TelemetrySlot);
+    if (!Memory.Create( Name, Size ))
+        return false;
+
+    memset( Memory.GetData(), 0, Size );
+
+    Header = static_cast<TelemetryHeader *>(Memory.GetData());
+    Slots = reinterpret_cast<TelemetrySlot *>(Header + 1);
+    Mask = RoundedCapacity - 1;
+
+    Header->Capacity = RoundedCapacity;
+    Header->SlotSize = sizeof(TelemetrySlot);
+    Header->Version = TELEMETRY_VERSION;
+    Header->WriteIndex.store( 0, memory_order_relaxed );
+    Header->Closed.store( 0, memory_order_relaxed );
+
+    // Magic last, readers ignore the block until it is fully initialized
+    atomic_thread_fence( memory_order_release );
+    Header->Magic = TELEMETRY_MAGIC;
+
+    return true;
+}
+
+void TelemetryPublisher::Close()
+{
+    // Tell readers the ring is gone, on POSIX they would otherwise keep the unlinked mapping
+    if (Header != NULL)
+        Header->Closed.store( 1, memory_order_release );
+
+    Memory.Close();
+
+    Header = NULL;
+    Slots = NULL;
+    Mask = 0;
+}
+
+void TelemetryPublisher::Publish( TelemetryRecord &Record )
+{
+    if (Header == NULL)
+        return;
+
+    // Single writer, so a relaxed load of our own index is enough
+    unsigned long long Index = Header->WriteIndex.load( memory_order_relaxed );
+    TelemetrySlot &Slot = Slots[Index & Mask];
+
+    Record.Tick = Index;
+
+    // Mark the slot as being written, then write the record, then publish it
+    unsigned int Sequence = Slot.Sequence.load( memory_order_relaxed );
+    Slot.Sequence.store( Sequence + 1, memory_order_relaxed );
+    atomic_thread_fence( memory_order_release );
+
+    memcpy( &Slot.Record, &Record, sizeof(TelemetryRecord) );
+
+    Slot.Sequence.store( Sequence + 2, memory_order_release );
+    Header->WriteIndex.store( Index + 1, memory_order_release );
+}
+
+
+// ------------------------------------------------------------------------------------
+// -------------------------------TelemetryReader Members------------------------------
+// ------------------------------------------------------------------------------------
+
+TelemetryReader::TelemetryReader()
+: Header(NULL), Slots(NULL), Mask(0)
+{
+}
+
+bool TelemetryReader::Open( const string &Name )
+{
+    Close();
+
+    if (!Memory.OpenReadOnly( Name ) || Memory.GetSize() < sizeof(TelemetryHeader))
+        return false;
+
+    const TelemetryHeader *Candidate = static_cast<const TelemetryHeader *>(Memory.GetData());
+    if (Candidate->Magic != TELEMETRY_MAGIC || Candidate->Version != TELEMETRY_VERSION ||
+        Candidate->SlotSize != sizeof(TelemetrySlot) ||
+        Memory.GetSize() < sizeof(TelemetryHeader) + Candidate->Capacity * sizeof(TelemetrySlot))
+    {
+        Memory.Close();
+        return false;
+    }
+    atomic_thread_fence( memory_order_acquire );
+
+    Header = Candidate;
+    Slots = reinterpret_cast<const TelemetrySlot *>(Header + 1);
+    Mask = Header->Capacity - 1;
+
+    return true;
+}
+
+void TelemetryReader::Close()
+{
+    Memory.Close();
+
+    Header = NULL;
+    Slots = NULL;
+    Mask = 0;
+}
+
+bool TelemetryReader::IsClosed() const
+{
+    return Header == NULL || Header->Closed.load( memory_order_acquire ) != 0;
+}
+
+unsigned long long TelemetryReader::GetWriteIndex() const
+{
+    return Header != NULL ? Header->WriteIndex.load( memory_order_acquire ) : 0;
+}
+
+unsigned long long TelemetryReader::GetOldestIndex() const
+{
+    unsigned long long WriteIndex = GetWriteIndex();
+
+    // The slot about to be written may be torn, so one less than a full ring is safe
+    return WriteIndex > Mask ? WriteIndex - Mask : 0;
+}
+
+bool TelemetryReader::Read( unsigned long long Index, TelemetryRecord &Record ) const
+{
+    if (Header == NULL)
+        return false;
+
+    const TelemetrySlot &Slot = Slots[Index & Mask];
+
+    // A publisher that died mid-write leaves the sequence odd forever, so give up after a while
+    static const unsigned int MaxAttempts = 64;
+
+    bool Consistent = false;
+    for (unsigned int Attempt = 0; Attempt < MaxAttempts && !Consistent; Attempt++)
+    {
+        unsigned int Before = Slot.Sequence.load( memory_order_acquire );
+        if (Before & 1)
+            continue;
+
+        memcpy( &Record, &Slot.Record, sizeof(TelemetryRecord) );
+
+        atomic_thread_fence( memory_order_acquire );
+        Consistent = Slot.Sequence.load( memory_order_relaxed ) == Before;
+    }
+
+    if (!Consistent)
+        return false;
+
+    // A different tick means the slot was not written yet or has been lapped
+    return Record.Tick == Index && Index < GetWriteIndex();
+}
\ No newline at end of file
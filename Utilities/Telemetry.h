@@ -0,0 +1,171 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+
+
+// ------------------------------------------------------------------------------------
+// ----------------------------------Included headers----------------------------------
+// ------------------------------------------------------------------------------------
+
+// C standard library
+#include <cstddef>
+
+// C++ standard library
+#include <atomic>
+#include <string>
+
+
+// ------------------------------------------------------------------------------------
+// --------------------------------------Structures------------------------------------
+// ------------------------------------------------------------------------------------
+
+// Per-tick measurements. The layout is shared with external readers, so fields are
+// fixed size and TELEMETRY_VERSION must be bumped whenever it changes.
+struct TelemetryRecord
+{
+    unsigned long long Tick;
+    double TimeSeconds;
+
+    float TickMilliseconds, UpdateMilliseconds, RenderMilliseconds, CollisionMilliseconds;
+
+    unsigned int Segments, CollisionTests;
+    unsigned long long MemoryBytes;
+};
+
+// One ring entry guarded by a sequence lock, odd sequence numbers mark a write in progress
+struct TelemetrySlot
+{
+    std::atomic<unsigned int> Sequence;
+    unsigned int Padding;
+
+    TelemetryRecord Record;
+};
+
+// Start of the shared memory block, followed by Capacity slots
+struct TelemetryHeader
+{
+    unsigned int Magic, Version;
+    unsigned int Capacity, SlotSize;
+
+    // Number of records ever published, the next record goes to WriteIndex % Capacity
+    std::atomic<unsigned long long> WriteIndex;
+    // Set by the publisher before it closes the block, readers must reattach
+    std::atomic<unsigned int> Closed;
+    unsigned int Padding;
+};
+
+static const unsigned int TELEMETRY_MAGIC = 0x534E4B54, // "SNKT"
+                          TELEMETRY_VERSION = 2;
+
+
+// ------------------------------------------------------------------------------------
+// ---------------------------------------Classes--------------------------------------
+// ------------------------------------------------------------------------------------
+
+// Named shared memory block, POSIX shm on Unix and a paging file mapping on Windows
+class SharedMemory
+{
+public:
+    SharedMemory();
+    ~SharedMemory();
+
+    // Create (or reuse) a writable block of Size bytes
+    bool Create( const std::string &Name, unsigned int Size );
+    // Map an existing block read-only
+    bool OpenReadOnly( const std::string &Name );
+    void Close();
+
+    // Accessors
+    inline void *GetData() const;
+    inline unsigned int GetSize() const;
+
+private:
+    std::string Name;
+    void *Data;
+    unsigned int Size;
+    bool Owner;
+
+#if defined(_WIN32)
+    void *Mapping;
+#endif
+
+    // Disable copying, the block owns its mapping
+    SharedMemory( const SharedMemory & );
+    SharedMemory &operator = ( const SharedMemory & );
+};
+
+// Writes per-tick records into a shared memory ring buffer.
+// Writes are wait-free: the game loop never waits on readers, a reader that falls a full
+// ring behind simply loses records and detects it from the tick numbers.
+class TelemetryPublisher
+{
+public:
+    TelemetryPublisher();
+
+    // Create the shared ring, Capacity is rounded up to a power of two
+    bool Open( const std::string &Name, unsigned int Capacity );
+    void Close();
+
+    inline bool IsOpen() const;
+
+    // Publish a record, Record.Tick is overwritten with the record's sequence number
+    void Publish( TelemetryRecord &Record );
+
+private:
+    SharedMemory Memory;
+    TelemetryHeader *Header;
+    TelemetrySlot *Slots;
+    unsigned int Mask;
+};
+
+// Reads records published by a TelemetryPublisher in another process
+class TelemetryReader
+{
+public:
+    TelemetryReader();
+
+    bool Open( const std::string &Name );
+    void Close();
+
+    // True when not attached or the publisher has closed the ring
+    bool IsClosed() const;
+
+    // Number of records published so far
+    unsigned long long GetWriteIndex() const;
+    // Oldest record index still guaranteed to be in the ring
+    unsigned long long GetOldestIndex() const;
+
+    // Copy record Index, returns false if it was overwritten, is not published yet or
+    // stayed mid-write for too long
+    bool Read( unsigned long long Index, TelemetryRecord &Record ) const;
+
+private:
+    SharedMemory Memory;
+    const TelemetryHeader *Header;
+    const TelemetrySlot *Slots;
+    unsigned int Mask;
+};
+
+
+// ------------------------------------------------------------------------------------
+// -----------------------------Inline function definitions----------------------------
+// ------------------------------------------------------------------------------------
+
+void *SharedMemory::GetData() const
+{
+    return Data;
+}
+
+unsigned int SharedMemory::GetSize() const
+{
+    return Size;
+}
+
+bool TelemetryPublisher::IsOpen() const
+{
+    return Header != NULL;
+}
+
+
+
+#endif
\ No newline at end of file
@@ -33,6 +33,12 @@ public:
 #define T_INHERITS_U( T, U ) (Conversion<const T *, const U *>::Exists && !Conversion<const T *, const void *>::SameType)
 
 
+// Map an integral constant to a distinct type, used for compile-time overload dispatch
+template <int v>
+struct Int2Type
+{ enum { Value = v }; };
+
+
 // Select between two types based on a boolean value, if flag is false specialization is used
 template <bool flag, typename T, typename U>
 struct Select